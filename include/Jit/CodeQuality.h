@@ -0,0 +1,82 @@
+//===---------------- include/Jit/CodeQuality.h -----------------*- C++ -*-===//
+//
+// LLILC
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Declaration of the per-method native code quality report.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef CODE_QUALITY_H
+#define CODE_QUALITY_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/CodeGen/MachineFunctionPass.h"
+#include "llvm/IR/Function.h"
+#include "llvm/Support/raw_ostream.h"
+#include <map>
+#include <string>
+
+struct LLILCJitContext;
+
+/// \brief Code quality statistics for a single jitted method.
+///
+/// The IR-level counts are gathered from the final IR handed to code
+/// generation, the machine-level counts by \p CodeQualityRecorder after
+/// code generation. Native sizes are only known in bytes for the method as
+/// a whole, so the split into prolog, epilog, body, throw blocks and funclets
+/// is reported in machine instructions.
+struct CodeQualityInfo {
+  /// \name IR statistics
+  //@{
+  std::map<std::string, unsigned> HelperCalls; ///< Calls per Jit helper.
+  unsigned BoundsChecks = 0; ///< Remaining range check failure paths.
+  unsigned NullChecks = 0;   ///< Remaining explicit null check failure paths.
+  unsigned Safepoints = 0;   ///< GC statepoints.
+  //@}
+
+  /// \name Machine code statistics
+  //@{
+  unsigned PrologInstructions = 0;   ///< Frame setup instructions.
+  unsigned EpilogInstructions = 0;   ///< Frame destroy instructions.
+  unsigned BodyInstructions = 0;     ///< Other main-body instructions.
+  unsigned ThrowInstructions = 0;    ///< Instructions in throw blocks.
+  unsigned FuncletInstructions = 0;  ///< Instructions in EH funclets.
+  unsigned ThrowBlocks = 0;          ///< Blocks that can only exit by throwing.
+  unsigned Funclets = 0;             ///< EH funclets.
+  unsigned Spills = 0;               ///< Stores to spill slots.
+  unsigned Reloads = 0;              ///< Loads from spill slots.
+  //@}
+
+  /// \brief Gather the IR statistics for the final IR of a method.
+  ///
+  /// \param Context Jit context for the method being compiled.
+  /// \param F The function that is about to be handed to code generation.
+  void recordIR(LLILCJitContext &Context, const llvm::Function &F);
+
+  /// \brief Print the report as a single-line JSON object.
+  ///
+  /// \param OS Stream to print to.
+  /// \param Context Jit context for the compiled method, providing the name
+  /// and native sizes.
+  void print(llvm::raw_ostream &OS, const LLILCJitContext &Context) const;
+};
+
+/// \brief MachineFunctionPass to record machine code statistics for the
+/// code quality report of the method being jitted.
+class CodeQualityRecorder : public llvm::MachineFunctionPass {
+public:
+  explicit CodeQualityRecorder() : MachineFunctionPass(ID) {}
+  bool runOnMachineFunction(llvm::MachineFunction &MF) override;
+
+private:
+  static char ID;
+};
+
+#endif // CODE_QUALITY_H
@@ -17,23 +17,54 @@
 #define LLILC_JIT_H
 
 #include "Pal/LLILCPal.h"
+#include "Reader/eeinfocache.h"
 #include "Reader/options.h"
 #include "llvm/ExecutionEngine/ExecutionEngine.h"
 #include "llvm/ExecutionEngine/RuntimeDyld.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/ThreadLocal.h"
+#include "llvm/Support/Timer.h"
 #include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
 #include "llvm/ExecutionEngine/Orc/NullResolver.h"
 #include "llvm/Config/config.h"
+#include <atomic>
+#include <mutex>
 
 class ABIInfo;
 class GcInfo;
+struct CodeQualityInfo;
 struct LLILCJitPerThreadState;
 namespace llvm {
 class EEMemoryManager;
 } // namespace llvm
 
+/// \brief Size of a method's IR once it has been read, used to pick how to
+/// compile it.
+struct MethodSize {
+  unsigned Instructions = 0; ///< IR instructions.
+  unsigned Blocks = 0;       ///< Basic blocks.
+  unsigned Allocas = 0;      ///< Stack allocations.
+  unsigned EHRegions = 0;    ///< EH clauses in the method's MSIL.
+  unsigned Safepoints = 0;   ///< Calls that may become GC safepoints.
+};
+
+/// \brief Statistics on translating CLR classes into LLVM types while
+/// reading one method.
+struct TypeTranslationInfo {
+  double Seconds = 0;             ///< Time spent building class types.
+  unsigned CompactClasses = 0;    ///< Classes given a compact layout.
+  unsigned CollapsedFields = 0;   ///< Non-GC fields folded into padding.
+  unsigned UntypedReferences = 0; ///< Reference fields typed as Object.
+
+  /// \brief Estimate the LLVMContext memory the compact layouts saved.
+  ///
+  /// Each collapsed field saves a struct element, and each reference field
+  /// typed as Object saves at least the named struct and pointer type that
+  /// would have been created for its class.
+  size_t estimateSavedBytes() const;
+};
+
 /// \brief This struct holds per-jit request state.
 ///
 /// LLILC is invoked to jit one method at a time. An \p LLILCJitContext
@@ -70,6 +101,23 @@ struct LLILCJitContext {
   std::unique_ptr<llvm::Module>
   getModuleForMethod(CORINFO_METHOD_INFO *MethodInfo);
 
+  /// \brief Recompute \p IRMemory from the current contents of the module.
+  void estimateIRMemory();
+
+  /// \brief Estimate the bytes held by the IR of one basic block.
+  static size_t estimateIRMemory(const llvm::BasicBlock &Block);
+
+  /// \brief Check whether this compile has exceeded its memory or time
+  /// budget.
+  ///
+  /// If it has, the abort is logged and \p BudgetExceededPhase is set, and
+  /// the caller should stop compiling so that the EE can fall back to the
+  /// default jit.
+  ///
+  /// \param Phase Description of the phase the compile has reached.
+  /// \returns true if the compile is over budget.
+  bool isOverBudget(const char *Phase);
+
 public:
   /// \name CoreCLR EE information
   //@{
@@ -117,8 +165,35 @@ public:
 
   /// \name GC Information
   ::GcInfo *GcInfo; ///< GcInfo for functions in CurrentModule
+
+  /// \name Code quality report
+  ::CodeQualityInfo *CodeQuality = nullptr; ///< Statistics for the method, if
+                                            ///< a report was requested.
+
+  /// \name Compile budget
+  //@{
+  llvm::TimeRecord StartTime;  ///< When the compile started.
+  size_t ReaderMemory = 0;     ///< Bytes allocated by the reader while it
+                               ///< is running.
+  size_t IRMemory = 0;         ///< Estimated bytes held by the method's IR.
+  const char *BudgetExceededPhase = nullptr; ///< Phase in which the compile
+                                             ///< went over budget, if any.
+  //@}
+
+  /// \name Compile strategy
+  ::MethodSize IRSize; ///< Size of the method's IR after reading.
+
+  /// \name Type translation statistics
+  ::TypeTranslationInfo TypeTranslation; ///< Class types built for the method.
+
+  /// \name EE query statistics
+  ::EEQueryCounts EEQueries; ///< Cacheable EE queries made by the reader.
 };
 
+/// \brief Exception thrown by the reader when the compile goes over its
+/// memory or time budget.
+class CompileBudgetExceededException {};
+
 /// \brief This struct holds per-thread Jit state.
 ///
 /// The Jit may be invoked concurrently on more than one thread. To avoid
@@ -132,8 +207,15 @@ public:
   /// Construct a new state.
   LLILCJitPerThreadState()
       : LLVMContext(), JitContext(nullptr), ClassTypeMap(),
-        ReverseClassTypeMap(), BoxedTypeMap(), ArrayTypeMap(), FieldIndexMap() {
-  }
+        ReverseClassTypeMap(), BoxedTypeMap(), ArrayTypeMap(), FieldIndexMap(),
+        EECache(), EECacheGeneration(0) {}
+
+  /// \brief Forget everything cached about EE handles.
+  ///
+  /// Used when the EE may have unloaded code, after which a handle can be
+  /// reused for a different class or field. The LLVM types already built
+  /// stay in \p LLVMContext, but are no longer found by handle.
+  void clearHandleCaches();
 
   /// Each thread maintains its own \p LLVMContext. This is where
   /// LLVM keeps definitions of types and similar constructs.
@@ -166,6 +248,13 @@ public:
   ///
   /// Used to build struct GEP instructions in LLVM IR for field accesses.
   std::map<CORINFO_FIELD_HANDLE, uint32_t> FieldIndexMap;
+
+  /// Answers to EE queries, shared by the compiles on this thread.
+  EEInfoCache EECache;
+
+  /// Value of \p LLILCJit::CacheGeneration when the handle caches were last
+  /// cleared.
+  uint32_t EECacheGeneration;
 };
 
 /// \brief Stub \p SymbolResolver that tells dynamic linker not to apply
@@ -275,6 +364,28 @@ private:
   /// \returns \p true if the conversion was successful.
   bool readMethod(LLILCJitContext *JitContext);
 
+  /// Run the IR optimizations requested by the jit options that must happen
+  /// before safepoint placement: general scalar optimization, cloning loops
+  /// to remove range checks, and vectorization.
+  /// \param JitContext Context record for the method's jit request.
+  void optimizeMethod(LLILCJitContext *JitContext);
+
+  /// Place safepoints and rewrite the method for precise GC, then clean up
+  /// the relocation sequences the rewrite introduced.
+  /// \param JitContext Context record for the method's jit request.
+  void insertStatepoints(LLILCJitContext *JitContext);
+
+  /// Measure the IR the reader produced and pick how to compile the method:
+  /// methods above the large-method thresholds get the minimal-latency
+  /// profile, and methods above the maximum size are declined.
+  /// \param JitContext Context record for the method's jit request.
+  /// \returns \p false if the method should be left to the default jit.
+  bool selectStrategy(LLILCJitContext *JitContext);
+
+  /// Register the scalar optimization passes, on first use. Only the
+  /// optional IR pipelines need them, so this is kept off the load path.
+  void initializeScalarOptsOnce();
+
 public:
   /// A pointer to the singleton jit instance.
   static LLILCJit *TheJit;
@@ -282,6 +393,15 @@ public:
 private:
   /// Thread local storage for the jit's per-thread state.
   llvm::sys::ThreadLocal<LLILCJitPerThreadState> State;
+
+  /// Guards the deferred registration of the scalar optimization passes.
+  std::once_flag ScalarOptsInitialized;
+
+  /// \brief Count of cache clearing requests from the EE.
+  ///
+  /// The caches live in per-thread state that \p clearCache can't reach, so
+  /// each thread clears its own caches when it sees this change.
+  std::atomic<uint32_t> CacheGeneration;
 };
 
 #endif // LLILC_JIT_H
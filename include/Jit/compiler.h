@@ -17,6 +17,7 @@
 #ifndef COMPILER_H
 #define COMPILER_H
 
+#include "CodeQuality.h"
 #include "GcInfo.h"
 #include "LLILCJit.h"
 #include "llvm/ExecutionEngine/ObjectMemoryBuffer.h"
@@ -33,7 +34,18 @@ namespace orc {
 class LLILCCompiler {
 public:
   /// \brief Construct a simple compile functor with the given target.
-  LLILCCompiler(TargetMachine &TM) : TM(TM) {}
+  ///
+  /// \param RecordGcInfo true if stack offsets of GC slots must be recorded
+  /// for precise GC reporting.
+  /// \param RecordCodeQuality true if machine code statistics must be
+  /// recorded for the code quality report.
+  /// \param DisableFastISel true if instruction selection must use
+  /// SelectionDAG even when the target would pick Fast ISel.
+  LLILCCompiler(TargetMachine &TM, bool RecordGcInfo = true,
+                bool RecordCodeQuality = false, bool DisableFastISel = false)
+      : TM(TM), RecordGcInfo(RecordGcInfo),
+        RecordCodeQuality(RecordCodeQuality),
+        DisableFastISel(DisableFastISel) {}
 
   /// \brief Compile a Module to an ObjectFile.
   object::OwningBinary<object::ObjectFile> operator()(Module &M) const {
@@ -44,7 +56,14 @@ public:
     MCContext *Ctx;
     if (TM.addPassesToEmitMC(PM, Ctx, ObjStream))
       llvm_unreachable("Target does not support MC emission.");
-    PM.add(new GcInfoRecorder());
+    // Pass setup decides on Fast ISel from the global options; override it
+    // on this (per-method) target machine before the passes run.
+    if (DisableFastISel)
+      TM.setFastISel(false);
+    if (RecordGcInfo)
+      PM.add(new GcInfoRecorder());
+    if (RecordCodeQuality)
+      PM.add(new CodeQualityRecorder());
     PM.run(M);
     std::unique_ptr<MemoryBuffer> ObjBuffer(
         new ObjectMemoryBuffer(std::move(ObjBufferSV)));
@@ -59,6 +78,9 @@ public:
 
 private:
   TargetMachine &TM;
+  bool RecordGcInfo;
+  bool RecordCodeQuality;
+  bool DisableFastISel;
 };
 } // namespace orc
 } // namespace llvm
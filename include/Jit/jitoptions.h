@@ -107,6 +107,11 @@ private:
   /// \returns true if current method is in that set.
   static bool queryIsCodeRangeMethod(LLILCJitContext &JitContext);
 
+  /// \brief Define set of methods for which to print a code quality report.
+  ///
+  /// \returns true if current method is in that set.
+  static bool queryIsCodeQualityMethod(LLILCJitContext &JitContext);
+
   static bool queryMethodSet(LLILCJitContext &JitContext, MethodSet &TheSet,
                              const char16_t *Name);
 
@@ -117,11 +122,70 @@ private:
   static bool queryNonNullNonEmpty(LLILCJitContext &JitContext,
                                    const char16_t *Name);
 
+  /// \brief Read a decimal unsigned config value.
+  ///
+  /// \param Name The name of the configuration variable.
+  /// \param Default The value to return if the config value is not set or
+  /// is not a number.
+  /// \returns The config value.
+  static uint32_t queryUnsigned(LLILCJitContext &JitContext,
+                                const char16_t *Name, uint32_t Default);
+
   /// \brief Set SIMD intrinsics using.
   ///
   /// \returns true if SIMD_INTRINSIC is set in the environment set.
   static bool queryDoSIMDIntrinsic(LLILCJitContext &JitContext);
 
+  /// \brief Set DoVectorize based on environment variable.
+  ///
+  /// \returns true if COMPlus_JitVectorize is set in the environment.
+  static bool queryDoVectorize(LLILCJitContext &JitContext);
+
+  /// \brief Set DoLoopCloning based on environment variable.
+  ///
+  /// \returns true if COMPlus_JitLoopClone is set in the environment.
+  static bool queryDoLoopCloning(LLILCJitContext &JitContext);
+
+  /// \brief Set DoEarlyOptimization based on environment variable.
+  ///
+  /// \returns true if COMPlus_JitEarlyOpt is set in the environment.
+  static bool queryDoEarlyOptimization(LLILCJitContext &JitContext);
+
+  /// \brief Decide whether to use the minimal-latency compile profile.
+  ///
+  /// Methods that are likely to run only once (class constructors), methods
+  /// the EE asks to compile without optimization, methods too large to be
+  /// worth optimizing, and methods in the COMPlus_AltJitMinOpts set are
+  /// compiled for the lowest JIT latency rather than for code quality.
+  ///
+  /// \returns true if the minimal profile should be used.
+  static bool queryDoMinimalCompile(LLILCJitContext &JitContext);
+
+  /// \brief Set MemoryBudget based on environment variable.
+  ///
+  /// \returns COMPlus_AltJitMemoryBudget megabytes in bytes, or 0 (no
+  /// limit) if it is not set.
+  static uint64_t queryMemoryBudget(LLILCJitContext &JitContext);
+
+  /// \brief Set TimeBudget based on environment variable.
+  ///
+  /// \returns COMPlus_AltJitTimeBudget in milliseconds, or 0 (no limit) if
+  /// it is not set.
+  static uint32_t queryTimeBudget(LLILCJitContext &JitContext);
+
+  /// \brief Set the IR size thresholds used to pick a compile strategy once
+  /// the method has been read, from COMPlus_AltJitLargeMethodInstrs,
+  /// COMPlus_AltJitLargeMethodBlocks and COMPlus_AltJitMaxMethodInstrs.
+  ///
+  /// \param Opts The options to fill in.
+  static void queryMethodSizeLimits(LLILCJitContext &JitContext,
+                                    ::Options &Opts);
+
+  /// \brief Set CompactClassFields based on environment variable.
+  ///
+  /// \returns COMPlus_AltJitCompactClassFields, or 64 if it is not set.
+  static uint32_t queryCompactClassFields(LLILCJitContext &JitContext);
+
 public:
   bool IsAltJit;        ///< True if running as the alternative JIT.
   bool IsExcludeMethod; ///< True if method is to be excluded.
@@ -130,6 +194,7 @@ public:
   bool IsMSILDumpMethod;  ///< True if dump of MSIL requested.
   bool IsLLVMDumpMethod;  ///< True if dump of LLVM requested.
   bool IsCodeRangeMethod; ///< True if desired to dump entry address and size.
+  bool IsCodeQualityMethod; ///< True if desired to dump code quality report.
 
 private:
   static MethodSet AltJitMethodSet;     ///< Singleton AltJit MethodSet.
@@ -139,6 +204,8 @@ private:
   static MethodSet MSILMethodSet;       ///< Methods to dump MSIL.
   static MethodSet LLVMMethodSet;       ///< Methods to dump LLVM IR.
   static MethodSet CodeRangeMethodSet;  ///< Methods to dump code range
+  static MethodSet CodeQualityMethodSet; ///< Methods to dump code quality
+  static MethodSet MinOptsMethodSet;     ///< Methods to compile minimally
 };
 
 #endif // JITOPTIONS_H
@@ -16,6 +16,7 @@
 #ifndef UTILITY_H
 #define UTILITY_H
 
+#include <atomic>
 #include <list>
 #include <cassert>
 #include <memory>
@@ -135,7 +136,7 @@ public:
 
   bool isEmpty() {
     assert(this->isInitialized());
-    return (this->MethodIDList->size() == 0);
+    return this->MethodIDList.load(std::memory_order_acquire)->empty();
   }
 
   /// Test whether specified method is matched in current MethodSet.
@@ -151,19 +152,20 @@ public:
   void init(std::unique_ptr<std::string> ConfigValue);
 
   /// Check whether current MethodSet has been initialized.
-  bool isInitialized() { return MethodIDList != nullptr; }
+  bool isInitialized() {
+    return MethodIDList.load(std::memory_order_acquire) != nullptr;
+  }
 
   /// \brief Parse the string S into one or more MethodIDs, and insert
   /// them into current MethodSet.
   void insert(std::unique_ptr<std::string> S);
 
 private:
-  /// Internal initialized flag.  This should only be accessed via interlocked
-  /// exchange operations, since several methods may be JIT'ing concurrently.
-  uint32_t Initialized = 0;
-
-  /// MethodSigList implementing the set.
-  std::list<MethodID> *MethodIDList = nullptr;
+  /// MethodSigList implementing the set. Several methods may be JIT'ing
+  /// concurrently, so the list is published with a single compare-exchange:
+  /// a non-null list is always complete, and later initializers discard
+  /// theirs.
+  std::atomic<std::list<MethodID> *> MethodIDList{nullptr};
 };
 
 /// \brief Class implementing miscellaneous conversion functions.
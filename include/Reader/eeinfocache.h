@@ -0,0 +1,94 @@
+//===---------------- include/Reader/eeinfocache.h -------------*- C++ -*-===//
+//
+// LLILC
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Declaration of the cache of EE query results used by the reader.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef EE_INFO_CACHE_H
+#define EE_INFO_CACHE_H
+
+#include <map>
+#include <utility>
+#include <vector>
+
+/// \brief An instance field of a class, as reported by the EE.
+struct FieldLayoutEntry {
+  CORINFO_FIELD_HANDLE Handle; ///< The field.
+  uint32_t Offset;             ///< Byte offset of the field in the instance.
+  CorInfoType Type;            ///< Type of the field.
+  CORINFO_CLASS_HANDLE Class;  ///< Class of the field, if it has one.
+};
+
+/// \brief The instance field layout of a class.
+///
+/// The EE only answers questions about one field at a time, so the layout
+/// is fetched once per class and kept here.
+struct ClassFieldLayout {
+  /// Number of instance fields, including those of base classes.
+  uint32_t NumInstanceFields = 0;
+
+  /// Fields declared by the class itself, in increasing offset order.
+  std::vector<FieldLayoutEntry> Fields;
+};
+
+/// \brief Counts of the cacheable EE queries made while reading a method.
+struct EEQueryCounts {
+  uint32_t Queries = 0; ///< Queries the reader made.
+  uint32_t EECalls = 0; ///< Queries that had to be passed on to the EE.
+};
+
+/// \brief Answers to EE queries that do not change once the EE has given
+/// them.
+///
+/// The reader consults the cache before asking the EE. A cache may be shared
+/// by all the compiles on a thread, except for ReadyToRun compiles: the EE
+/// records the dependencies of the method being compiled as it answers, so
+/// each of those gets a cache of its own.
+///
+/// Handles stay valid until the EE unloads the code that defines them, and
+/// the EE asks the jit to drop its caches when that happens.
+struct EEInfoCache {
+  /// Map from class handles to their instance field layouts.
+  std::map<CORINFO_CLASS_HANDLE, ClassFieldLayout> ClassFieldLayouts;
+
+  /// Map from field handles to their types and classes.
+  std::map<CORINFO_FIELD_HANDLE, std::pair<CorInfoType, CORINFO_CLASS_HANDLE>>
+      FieldTypes;
+
+  /// Map from class handles to their attributes.
+  std::map<CORINFO_CLASS_HANDLE, uint32_t> ClassAttribs;
+
+  /// Map from class handles to their instance sizes.
+  std::map<CORINFO_CLASS_HANDLE, uint32_t> ClassSizes;
+
+  /// Map from class handles to the CorInfoType they correspond to.
+  std::map<CORINFO_CLASS_HANDLE, CorInfoType> ClassTypes;
+
+  /// Map from class handles to whether they are value classes.
+  std::map<CORINFO_CLASS_HANDLE, bool> ValueClasses;
+
+  /// Map from helpers to their direct and indirect addresses.
+  std::map<CorInfoHelpFunc, std::pair<void *, void *>> Helpers;
+
+  /// \brief Forget all the cached answers.
+  void clear() {
+    ClassFieldLayouts.clear();
+    FieldTypes.clear();
+    ClassAttribs.clear();
+    ClassSizes.clear();
+    ClassTypes.clear();
+    ValueClasses.clear();
+    Helpers.clear();
+  }
+};
+
+#endif // EE_INFO_CACHE_H
@@ -56,7 +56,21 @@ struct Options {
   bool LogGcInfo;           ///< Generate GCInfo Translation logs
   bool ExecuteHandlers;     ///< Squelch handler suppression.
   bool DoSIMDIntrinsic;     ///< True if SIMD intrinsic is on.
+  bool DoVectorize;         ///< Run the loop and SLP vectorizers.
+  bool DoLoopCloning;       ///< Version loops to remove range checks.
+  bool DoEarlyOptimization; ///< Optimize IR before safepoint placement.
+  bool DoMinimalCompile;    ///< Compile for latency (e.g. run-once methods).
   unsigned PreferredIntrinsicSIMDVectorLength; ///< Prefer Intrinsic SIMD Vector
   /// Length in bytes.
+  uint64_t MemoryBudget; ///< Bytes one compile may use; 0 for no limit.
+  uint32_t TimeBudget;   ///< Milliseconds one compile may take; 0 for no limit.
+  uint32_t LargeMethodInstructions; ///< IR instructions above which a method
+                                    ///< is compiled minimally.
+  uint32_t LargeMethodBlocks;       ///< Blocks above which a method is
+                                    ///< compiled minimally.
+  uint32_t MaxMethodInstructions;   ///< IR instructions above which a method
+                                    ///< is declined; 0 for no limit.
+  uint32_t CompactClassFields;      ///< Fields above which a class gets a
+                                    ///< compact layout; 0 to never compact.
 };
 #endif // OPTIONS_H
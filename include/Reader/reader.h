@@ -34,6 +34,7 @@
 #include "cor.h"
 #include "corjit.h"
 #include "readerenum.h"
+#include "eeinfocache.h"
 #include "gverify.h"
 
 // as defined in src\vm\vars.hpp
@@ -1350,6 +1351,10 @@ public:
   /// True if this method contains the 'localloc' MSIL opcode.
   bool HasLocAlloc;
 
+  /// True if this method contains a branch to the same or an earlier MSIL
+  /// offset, i.e. it may contain a loop.
+  bool HasBackwardBranch;
+
   /// True if the client has optimistically transformed tail.
   /// recursion into a branch.
   bool HasOptimisticTailRecursionTransform;
@@ -1365,6 +1370,15 @@ private:
   ICorJitInfo *JitInfo;
   uint32_t Flags; // original flags that were passed to compileMethod
 
+protected:
+  /// Cache of EE query results, supplied by the client.
+  EEInfoCache *EECache;
+
+  /// Counts of the cacheable EE queries made while reading this method.
+  EEQueryCounts EEQueries;
+
+private:
+
   // SEQUENCE POINT Info
   ReaderBitVector *CustomSequencePoints;
 
@@ -2420,6 +2434,16 @@ public:
   uint32_t getClassNumInstanceFields(CORINFO_CLASS_HANDLE Class);
   CORINFO_FIELD_HANDLE getFieldInClass(CORINFO_CLASS_HANDLE Class,
                                        uint32_t Ordinal);
+
+  /// \brief Get the instance field layout of a class.
+  ///
+  /// The layout is fetched from the EE on first use and then answered from
+  /// \p EECache, along with the types of the fields it describes.
+  ///
+  /// \param Class The class to get the layout of.
+  /// \returns The number of instance fields of the class and the fields it
+  /// declares itself, in increasing offset order.
+  const ClassFieldLayout &getClassFieldLayout(CORINFO_CLASS_HANDLE Class);
   CorInfoType getFieldInfo(CORINFO_CLASS_HANDLE Class, uint32_t Ordinal,
                            uint32_t *FieldOffset,
                            CORINFO_CLASS_HANDLE *FieldClass);
@@ -2485,6 +2509,7 @@ public:
   bool classHasGCPointers(CORINFO_CLASS_HANDLE Class);
   uint32_t getClassAttribs(CORINFO_CLASS_HANDLE Class);
   uint32_t getClassSize(CORINFO_CLASS_HANDLE Class);
+  bool isValueClass(CORINFO_CLASS_HANDLE Class);
   CorInfoType getClassType(CORINFO_CLASS_HANDLE Class);
   void getClassType(CORINFO_CLASS_HANDLE Class, uint32_t Attribs,
                     CorInfoType *CorInfoType, uint32_t *Size);
@@ -2533,6 +2558,9 @@ public:
   void setMethodAttribs(CORINFO_METHOD_HANDLE Handle,
                         CorInfoMethodRuntimeFlags Flag);
 
+  /// \brief Get the counts of cacheable EE queries made so far.
+  const EEQueryCounts &getEEQueryCounts() const { return EEQueries; }
+
   virtual std::string appendClassNameAsString(CORINFO_CLASS_HANDLE Class,
                                               bool IncludeNamespace,
                                               bool FullInst,
@@ -3361,6 +3389,33 @@ public:
   /// \returns The class handle that corresponds to the type of the node.
   virtual CORINFO_CLASS_HANDLE inferThisClass(IRNode *ThisArgument) = 0;
 
+  /// \brief Record the target of a delegate constructed in this method, so
+  ///        that invokes of the delegate can call the target directly.
+  ///
+  /// The client must forget the record if the delegate node is deleted, and
+  /// must not return a deleted bound instance.
+  ///
+  /// \param Delegate      The new delegate object.
+  /// \param Method        Method the delegate will invoke.
+  /// \param MethodToken   Token used to load the method pointer.
+  /// \param TargetObject  Instance the method is bound to.
+  virtual void recordDelegateTarget(IRNode *Delegate,
+                                    CORINFO_METHOD_HANDLE Method,
+                                    mdToken MethodToken,
+                                    IRNode *TargetObject) = 0;
+
+  /// \brief Look up the target recorded for a delegate.
+  ///
+  /// \param Delegate           The delegate being invoked.
+  /// \param[out] Method        Method the delegate will invoke.
+  /// \param[out] MethodToken   Token used to load the method pointer.
+  /// \param[out] TargetObject  Instance the method is bound to.
+  /// \returns true if the target of \p Delegate is known.
+  virtual bool getDelegateTarget(IRNode *Delegate,
+                                 CORINFO_METHOD_HANDLE *Method,
+                                 mdToken *MethodToken,
+                                 IRNode **TargetObject) = 0;
+
   // Called once region tree has been built.
   virtual void setEHInfo(EHRegion *EhRegionTree,
                          EHRegionList *EhRegionList) = 0;
@@ -3547,6 +3602,14 @@ private:
   char DummyLastBaseField;
   // Fields after this one will not be initialized in the constructor.
   ///////////////////////////////////////////////////////////////////////
+
+  /// Map from method handles to their attribs, for this compile only.
+  std::map<CORINFO_METHOD_HANDLE, uint32_t> MethodAttribs;
+
+  /// Map from method handles to their method and module names, for this
+  /// compile only.
+  std::map<CORINFO_METHOD_HANDLE, std::pair<const char *, const char *>>
+      MethodNames;
 };
 
 /// \brief The exception that is thrown when a particular operation is not yet
@@ -27,6 +27,8 @@
 #include "llvm/IR/CallSite.h"
 #include "llvm/IR/DIBuilder.h"
 #include "llvm/IR/DebugInfoMetadata.h"
+#include "llvm/IR/ValueHandle.h"
+#include "llvm/IR/ValueMap.h"
 #include "GcInfo.h"
 #include "reader.h"
 #include "abi.h"
@@ -200,6 +202,13 @@ public:
     this->BoxedTypeMap = &State->BoxedTypeMap;
     this->ArrayTypeMap = &State->ArrayTypeMap;
     this->FieldIndexMap = &State->FieldIndexMap;
+    // ReadyToRun compiles must ask the EE themselves, so that it records
+    // their dependencies.
+    if ((JitContext->Flags & CORJIT_FLG_READYTORUN) != 0) {
+      this->EECache = &MethodEECache;
+    } else {
+      this->EECache = &State->EECache;
+    }
   }
 
   static bool isValidStackType(IRNode *Node);
@@ -786,6 +795,11 @@ public:
 
   IRNode *genNullCheck(IRNode *Node) override;
 
+  /// \brief Determine whether GC stack slots must be recorded in GcFuncInfo.
+  ///
+  /// \returns true when precise GC info will be reported for this method.
+  bool recordsGcAllocas();
+
   llvm::AllocaInst *createAlloca(llvm::Type *T,
                                  llvm::Value *ArraySize = nullptr,
                                  const llvm::Twine &Name = "");
@@ -866,6 +880,13 @@ public:
 
   CORINFO_CLASS_HANDLE inferThisClass(IRNode *ThisArgument) override;
 
+  void recordDelegateTarget(IRNode *Delegate, CORINFO_METHOD_HANDLE Method,
+                            mdToken MethodToken,
+                            IRNode *TargetObject) override;
+
+  bool getDelegateTarget(IRNode *Delegate, CORINFO_METHOD_HANDLE *Method,
+                         mdToken *MethodToken, IRNode **TargetObject) override;
+
   // Called once region tree has been built.
   void setEHInfo(EHRegion *EhRegionTree, EHRegionList *EhRegionList) override;
 
@@ -987,6 +1008,24 @@ private:
                              CORINFO_RESOLVED_TOKEN *ResolvedToken,
                              CORINFO_FIELD_INFO *FieldInfo) override;
 
+  /// Try to replace a load of a static readonly field with its current value.
+  ///
+  /// This is possible once the field's class has been initialized, since the
+  /// value can no longer change. Only primitive fields at a fixed address are
+  /// folded; object references are not, because the object they refer to may
+  /// still be moved by the GC.
+  ///
+  /// \param FieldToken  Resolved token for the field.
+  /// \param FieldInfo   Field information from the EE.
+  /// \param FieldTy     LLVM type of the field.
+  /// \param FieldCorType CorInfoType of the field.
+  /// \returns The constant value of the field on the evaluation stack, or
+  ///          nullptr if the load could not be folded.
+  IRNode *loadReadOnlyStaticFieldConstant(CORINFO_RESOLVED_TOKEN *FieldToken,
+                                          CORINFO_FIELD_INFO *FieldInfo,
+                                          llvm::Type *FieldTy,
+                                          CorInfoType FieldCorType);
+
   /// Get a node with the same value as Addr but typed as a pointer to the type
   /// corresponding to CorInfoType and ClassHandle.
   ///
@@ -1202,6 +1241,11 @@ private:
 
   /// Generate a call to the throw helper if the condition is met.
   ///
+  /// When generating optimized code, all conditional throws of the same
+  /// helper within one EH region branch to a single shared throw block, so
+  /// e.g. a run of checked arithmetic costs one compare-and-branch per
+  /// operation and one out-of-line throw.
+  ///
   /// \param Condition Condition that will trigger the throw.
   /// \param HelperId Id of the throw-helper.
   /// \param ThrowBlockName Name of the basic block that will contain the throw.
@@ -1730,6 +1774,15 @@ private:
   /// \param FinallyRegion  The region whose IR is to be cloned.
   void cloneFinallyBody(EHRegion *FinallyRegion);
 
+  /// Replace the continuation dispatch at the end of a non-exceptional
+  /// finally body with a direct branch when every leave through the finally
+  /// targets the same continuation, and remove the then-dead selector
+  /// variable and its stores.
+  ///
+  /// \param ExitSwitch  The switch on the continuation selector that ends
+  ///                    the non-exceptional copy of the finally.
+  void removeRedundantFinallySelector(llvm::SwitchInst *ExitSwitch);
+
   /// Determine whether the IR generated for the given handler should be
   /// allowed to execute (as opposed to inserting a failfast at handler entry).
   /// Does not affect non-exceptional executions of finally handlers.
@@ -1761,6 +1814,7 @@ private:
   std::map<std::tuple<CorInfoType, CORINFO_CLASS_HANDLE, uint32_t, bool>,
            llvm::Type *> *ArrayTypeMap;
   std::map<CORINFO_FIELD_HANDLE, uint32_t> *FieldIndexMap;
+  EEInfoCache MethodEECache; ///< EE query cache for ReadyToRun compiles.
   llvm::StringMap<uint64_t> *NameToHandleMap; ///< Map from GlobalVariable names
                                               ///< to handles corresponding to
                                               ///< those GlobalVariables.
@@ -1778,6 +1832,23 @@ private:
   std::vector<llvm::Value *> Arguments;
   llvm::Value *IndirectResult;
   llvm::DenseMap<uint32_t, llvm::StoreInst *> ContinuationStoreMap;
+  /// \brief Map from a throw helper and the EH region it is raised in to the
+  /// shared block that calls that helper.  See \p genConditionalThrow.
+  std::map<std::pair<CorInfoHelpFunc, EHRegion *>, llvm::BasicBlock *>
+      ThrowBlockMap;
+  /// \brief Target of a delegate constructed in the method being read.
+  struct DelegateTargetInfo {
+    CORINFO_METHOD_HANDLE Method; ///< Method the delegate will invoke.
+    mdToken MethodToken;          ///< Token used to load the method pointer.
+    llvm::WeakVH TargetObject;    ///< Instance the method is bound to.
+  };
+  /// \brief Map from delegate objects constructed in this method to their
+  /// targets.  Entries go away when the delegate is deleted.  See
+  /// \p recordDelegateTarget.
+  llvm::ValueMap<llvm::Value *, DelegateTargetInfo> KnownDelegateTargets;
+  /// \brief Blocks already counted in the jit context's running estimate of
+  /// the method's IR size.  See \p endFlowGraphNode.
+  llvm::SmallPtrSet<llvm::BasicBlock *, 16> EstimatedBlocks;
   llvm::SmallPtrSet<llvm::Value *, 5> StructPointers; ///< This set contains
                                                       ///< pointers to structs
                                                       ///< that we create
@@ -1822,6 +1893,12 @@ private:
                                                 ///< helper function.
                                                 ///< This constant is from the
                                                 ///< legacy jit.
+
+  /// Largest constant localloc size, in bytes, that may be given a fixed
+  /// frame slot instead of a dynamic stack allocation. Kept well under a page
+  /// so that such slots never require stack probes.
+  static const uint32_t MaxFixedLocAllocSize = 256;
+
   struct DebugInfo {
     llvm::DICompileUnit *TheCU;
     llvm::DIScope *FunctionScope;
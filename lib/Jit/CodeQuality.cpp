@@ -0,0 +1,247 @@
+//===---- lib/Jit/CodeQuality.cpp -----------------------------*- C++ -*-===//
+//
+// LLILC
+//
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license.
+// See LICENSE file in the project root for full license information.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// \brief Implementation of the per-method native code quality report.
+///
+//===----------------------------------------------------------------------===//
+
+#include "earlyincludes.h"
+#include "jitpch.h"
+#include "LLILCJit.h"
+#include "CodeQuality.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/CodeGen/MachineFrameInfo.h"
+#include "llvm/CodeGen/MachineFunction.h"
+#include "llvm/IR/CFG.h"
+#include "llvm/IR/CallSite.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Operator.h"
+#include "llvm/IR/Statepoint.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Target/TargetInstrInfo.h"
+#include "llvm/Target/TargetSubtargetInfo.h"
+#include <algorithm>
+
+using namespace llvm;
+
+/// \brief Find the name of the Jit helper a call target refers to.
+///
+/// Helper call targets are built from the address in a global variable named
+/// "<helper name>::JitHelper", possibly loaded through an indirection cell.
+///
+/// \param Target The called value.
+/// \returns The helper name, or an empty string if the call is not a
+/// helper call.
+static StringRef getHelperName(const Value *Target) {
+  while (true) {
+    if (const Operator *Op = dyn_cast<Operator>(Target)) {
+      unsigned Opcode = Op->getOpcode();
+      if (Opcode == Instruction::IntToPtr || Opcode == Instruction::PtrToInt ||
+          Opcode == Instruction::BitCast || Opcode == Instruction::Load) {
+        Target = Op->getOperand(0);
+        continue;
+      }
+    } else if (const LoadInst *Load = dyn_cast<LoadInst>(Target)) {
+      Target = Load->getPointerOperand();
+      continue;
+    }
+    break;
+  }
+
+  const GlobalVariable *Global = dyn_cast<GlobalVariable>(Target);
+  if (Global == nullptr) {
+    return StringRef();
+  }
+  StringRef Name = Global->getName();
+  size_t Suffix = Name.find("::JitHelper");
+  if (Suffix == StringRef::npos) {
+    return StringRef();
+  }
+  return Name.substr(0, Suffix);
+}
+
+void CodeQualityInfo::recordIR(LLILCJitContext &Context, const Function &F) {
+  StringRef RangeCheckHelper =
+      Context.JitInfo->getHelperName(CORINFO_HELP_RNGCHKFAIL);
+  StringRef NullRefHelper =
+      Context.JitInfo->getHelperName(CORINFO_HELP_THROWNULLREF);
+
+  for (const BasicBlock &Block : F) {
+    for (const Instruction &Instr : Block) {
+      ImmutableCallSite Call(&Instr);
+      if (!Call) {
+        continue;
+      }
+
+      const Value *Target = Call.getCalledValue();
+      if (isStatepoint(Call)) {
+        ++Safepoints;
+        Target = ImmutableStatepoint(Call).getCalledValue();
+      }
+
+      StringRef Helper = getHelperName(Target);
+      if (Helper.empty()) {
+        continue;
+      }
+
+      ++HelperCalls[Helper.str()];
+
+      // Conditional throws of the same exception share one throw block, so
+      // each branch into the block is a separate check.
+      if (Helper == RangeCheckHelper || Helper == NullRefHelper) {
+        unsigned Checks = std::max<unsigned>(
+            1, std::distance(pred_begin(&Block), pred_end(&Block)));
+        if (Helper == RangeCheckHelper) {
+          BoundsChecks += Checks;
+        } else {
+          NullChecks += Checks;
+        }
+      }
+    }
+  }
+}
+
+/// \brief Print a string as a JSON string literal.
+static void printJSONString(raw_ostream &OS, StringRef String) {
+  OS << '"';
+  for (char C : String) {
+    if (C == '"' || C == '\\') {
+      OS << '\\' << C;
+    } else if ((unsigned char)C < 0x20) {
+      OS << format("\\u%04x", (unsigned char)C);
+    } else {
+      OS << C;
+    }
+  }
+  OS << '"';
+}
+
+void CodeQualityInfo::print(raw_ostream &OS,
+                            const LLILCJitContext &Context) const {
+  const MethodSize &IRSize = Context.IRSize;
+  OS << "{\"method\": ";
+  printJSONString(OS, Context.MethodName);
+  OS << ", \"strategy\": \""
+     << (Context.Options->DoMinimalCompile ? "minimal" : "full") << '"'
+     << ", \"irSize\": {\"instructions\": " << IRSize.Instructions
+     << ", \"blocks\": " << IRSize.Blocks
+     << ", \"allocas\": " << IRSize.Allocas
+     << ", \"ehRegions\": " << IRSize.EHRegions
+     << ", \"safepoints\": " << IRSize.Safepoints << "}"
+     << ", \"typeTranslation\": {\"us\": "
+     << (uint64_t)(Context.TypeTranslation.Seconds * 1000000)
+     << ", \"compactClasses\": " << Context.TypeTranslation.CompactClasses
+     << ", \"collapsedFields\": " << Context.TypeTranslation.CollapsedFields
+     << ", \"untypedReferences\": "
+     << Context.TypeTranslation.UntypedReferences << ", \"savedBytes\": "
+     << (uint64_t)Context.TypeTranslation.estimateSavedBytes() << "}"
+     << ", \"eeQueries\": {\"made\": " << Context.EEQueries.Queries
+     << ", \"eeCalls\": " << Context.EEQueries.EECalls << "}"
+     << ", \"size\": " << (uint64_t)Context.HotCodeSize
+     << ", \"readOnlyDataSize\": " << (uint64_t)Context.ReadOnlyDataSize
+     << ", \"instructions\": {\"prolog\": " << PrologInstructions
+     << ", \"epilog\": " << EpilogInstructions
+     << ", \"body\": " << BodyInstructions
+     << ", \"throwBlocks\": " << ThrowInstructions
+     << ", \"funclets\": " << FuncletInstructions << "}"
+     << ", \"throwBlocks\": " << ThrowBlocks << ", \"funclets\": " << Funclets
+     << ", \"spills\": " << Spills << ", \"reloads\": " << Reloads
+     << ", \"boundsChecks\": " << BoundsChecks
+     << ", \"nullChecks\": " << NullChecks
+     << ", \"safepoints\": " << Safepoints << ", \"helperCalls\": {";
+  bool First = true;
+  for (const auto &Helper : HelperCalls) {
+    if (!First) {
+      OS << ", ";
+    }
+    First = false;
+    printJSONString(OS, Helper.first);
+    OS << ": " << Helper.second;
+  }
+  OS << "}}\n";
+}
+
+char CodeQualityRecorder::ID = 0;
+
+bool CodeQualityRecorder::runOnMachineFunction(MachineFunction &MF) {
+  LLILCJitContext *Context = LLILCJit::TheJit->getLLILCJitContext();
+  CodeQualityInfo *Info = Context->CodeQuality;
+  if (Info == nullptr || MF.getFunction()->getName() != Context->MethodName) {
+    return false;
+  }
+
+  const TargetInstrInfo *TII = MF.getSubtarget().getInstrInfo();
+  const MachineFrameInfo *FrameInfo = MF.getFrameInfo();
+
+  // Blocks belonging to funclets: everything reachable from a funclet entry
+  // without passing through the funclet's return (catchret/cleanupret).
+  SmallPtrSet<const MachineBasicBlock *, 8> FuncletBlocks;
+  SmallVector<const MachineBasicBlock *, 8> Worklist;
+  for (const MachineBasicBlock &Block : MF) {
+    if (Block.isEHFuncletEntry()) {
+      ++Info->Funclets;
+      Worklist.push_back(&Block);
+    }
+  }
+  while (!Worklist.empty()) {
+    const MachineBasicBlock *Block = Worklist.pop_back_val();
+    if (!FuncletBlocks.insert(Block).second) {
+      continue;
+    }
+    if (!Block->empty() && Block->back().isReturn()) {
+      continue;
+    }
+    for (const MachineBasicBlock *Successor : Block->successors()) {
+      if (!Successor->isEHPad()) {
+        Worklist.push_back(Successor);
+      }
+    }
+  }
+
+  for (const MachineBasicBlock &Block : MF) {
+    bool IsFunclet = FuncletBlocks.count(&Block) != 0;
+    bool IsThrow = !IsFunclet && Block.succ_empty() && !Block.empty() &&
+                   !Block.back().isReturn();
+    if (IsThrow) {
+      ++Info->ThrowBlocks;
+    }
+
+    for (const MachineInstr &Instr : Block) {
+      if (Instr.isDebugValue() || Instr.isCFIInstruction() || Instr.isLabel()) {
+        continue;
+      }
+
+      int FrameIndex;
+      if (TII->isStoreToStackSlotPostFE(&Instr, FrameIndex) &&
+          FrameInfo->isSpillSlotObjectIndex(FrameIndex)) {
+        ++Info->Spills;
+      } else if (TII->isLoadFromStackSlotPostFE(&Instr, FrameIndex) &&
+                 FrameInfo->isSpillSlotObjectIndex(FrameIndex)) {
+        ++Info->Reloads;
+      }
+
+      if (IsFunclet) {
+        ++Info->FuncletInstructions;
+      } else if (Instr.getFlag(MachineInstr::FrameSetup)) {
+        ++Info->PrologInstructions;
+      } else if (Instr.getFlag(MachineInstr::FrameDestroy)) {
+        ++Info->EpilogInstructions;
+      } else if (IsThrow) {
+        ++Info->ThrowInstructions;
+      } else {
+        ++Info->BodyInstructions;
+      }
+    }
+  }
+
+  return false;
+}
@@ -16,6 +16,7 @@
 #include "earlyincludes.h"
 #include "jitpch.h"
 #include "LLILCJit.h"
+#include "CodeQuality.h"
 #include "GcInfo.h"
 #include "jitoptions.h"
 #include "compiler.h"
@@ -36,6 +37,7 @@
 #include "llvm/IR/DebugLoc.h"
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IRReader/IRReader.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/LLVMContext.h"
@@ -55,8 +57,10 @@
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/Timer.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/Transforms/Scalar.h"
 #include "llvm/Transforms/IPO/PassManagerBuilder.h"
+#include "llvm/Transforms/Vectorize.h"
 #include <string>
 
 using namespace llvm;
@@ -163,12 +167,6 @@ ICorJitCompiler *__stdcall getJit() {
     cl::ParseEnvironmentOptions("LLILCJit", "COMPlus_AltJitOptions");
 
     auto &Opts = cl::getRegisteredOptions();
-    if (Opts["fast-isel"]->getNumOccurrences() == 0) {
-      // Statepoint GC does not support Fast ISel yet.
-      // TODO: Enable Statepoints with fast-isel
-      // https://github.com/dotnet/llilc/issues/512
-      Opts["fast-isel"]->addOccurrence(0, "fast-isel", "false");
-    }
     if (Opts["disable-cgp-gc-opts"]->getNumOccurrences() == 0) {
       // There is a bug in the CGP gc-opts, so this optimization
       // is disabled until that issue is fixed.
@@ -183,18 +181,26 @@ ICorJitCompiler *__stdcall getJit() {
 }
 
 // Construct the JIT instance
-LLILCJit::LLILCJit() {
+//
+// Only what every compile needs is initialized here, since this runs when the
+// jit is loaded. Scalar optimization passes are registered when an optional
+// pipeline first runs, and the target asm parser when bitcode is side-loaded.
+LLILCJit::LLILCJit() : CacheGeneration(0) {
   PassRegistry &Registry = *PassRegistry::getPassRegistry();
   initializeCore(Registry);
-  initializeScalarOpts(Registry);
 
   InitializeNativeTarget();
   InitializeNativeTargetAsmPrinter();
-  InitializeNativeTargetAsmParser();
 
   llvm::linkCoreCLRGC();
 }
 
+void LLILCJit::initializeScalarOptsOnce() {
+  std::call_once(ScalarOptsInitialized, []() {
+    initializeScalarOpts(*PassRegistry::getPassRegistry());
+  });
+}
+
 #ifdef LLVM_ON_WIN32
 // Windows only
 BOOL WINAPI DllMain(HANDLE Instance, DWORD Reason, LPVOID Reserved) {
@@ -223,6 +229,15 @@ LLILCJitContext::~LLILCJitContext() {
   State->JitContext = TopContext->Next;
 }
 
+void LLILCJitPerThreadState::clearHandleCaches() {
+  ClassTypeMap.clear();
+  ReverseClassTypeMap.clear();
+  BoxedTypeMap.clear();
+  ArrayTypeMap.clear();
+  FieldIndexMap.clear();
+  EECache.clear();
+}
+
 // This is the method invoked by the EE to Jit code.
 CorJitResult LLILCJit::compileMethod(ICorJitInfo *JitInfo,
                                      CORINFO_METHOD_INFO *MethodInfo,
@@ -235,6 +250,10 @@ CorJitResult LLILCJit::compileMethod(ICorJitInfo *JitInfo,
     return CORJIT_INTERNALERROR;
   }
 
+  // Start the wall clock for the compile time reported with the code range
+  // and checked against the time budget.
+  TimeRecord StartTime = TimeRecord::getCurrentTime(true);
+
   // Prep main outputs
   *NativeEntry = nullptr;
   *NativeSizeOfCode = 0;
@@ -246,10 +265,21 @@ CorJitResult LLILCJit::compileMethod(ICorJitInfo *JitInfo,
     State.set(PerThreadState);
   }
 
+  // Drop what was cached about EE handles before the EE last asked us to. A
+  // compile that is already under way on this thread may still be using it,
+  // so only the outermost compile does this.
+  uint32_t Generation = CacheGeneration.load(std::memory_order_acquire);
+  if ((PerThreadState->JitContext == nullptr) &&
+      (PerThreadState->EECacheGeneration != Generation)) {
+    PerThreadState->clearHandleCaches();
+    PerThreadState->EECacheGeneration = Generation;
+  }
+
   // Set up context for this Jit request
   LLILCJitContext Context(PerThreadState);
 
   // Fill in context information from the CLR
+  Context.StartTime = StartTime;
   Context.JitInfo = JitInfo;
   Context.MethodInfo = MethodInfo;
   Context.Flags = Flags;
@@ -302,8 +332,12 @@ CorJitResult LLILCJit::compileMethod(ICorJitInfo *JitInfo,
     // calls as possible in that form and use shared delay-load thunks when
     // possible. Setting OptLevel to Default increases the chances of calls via
     // memory and setting CodeModel to Default enables rel32 relocations.
-    if ((Context.Options->OptLevel != ::OptLevel::DEBUG_CODE) || IsNgen ||
-        IsReadyToRun) {
+    //
+    // Debug code and minimal compiles otherwise use CodeGenOpt::None, which
+    // selects Fast ISel and the fast register allocator.
+    bool IsMinimal = (Context.Options->OptLevel == ::OptLevel::DEBUG_CODE) ||
+                     Context.Options->DoMinimalCompile;
+    if (!IsMinimal || IsNgen || IsReadyToRun) {
       OptLevel = CodeGenOpt::Level::Default;
     } else {
       OptLevel = CodeGenOpt::Level::None;
@@ -329,8 +363,23 @@ CorJitResult LLILCJit::compileMethod(ICorJitInfo *JitInfo,
     };
     orc::ObjectTransformLayer<decltype(Loader), decltype(ReserveUnwindSpace)>
         UnwindReserver(Loader, ReserveUnwindSpace);
+    // Under conservative GC nothing but the GC info header is reported, so
+    // the machine-level GC slot recording can be skipped.
+    //
+    // Statepoint GC does not support Fast ISel yet, so methods with
+    // statepoints go through SelectionDAG unless Fast ISel was explicitly
+    // requested via COMPlus_AltJitOptions. Everything else keeps the target's
+    // default, which is Fast ISel for CodeGenOpt::None.
+    // TODO: Enable Statepoints with fast-isel
+    // https://github.com/dotnet/llilc/issues/512
+    static const bool FastISelRequested =
+        cl::getRegisteredOptions()["fast-isel"]->getNumOccurrences() != 0;
+    bool DisableFastISel =
+        Context.Options->DoInsertStatepoints && !FastISelRequested;
     orc::IRCompileLayer<decltype(UnwindReserver)> Compiler(
-        UnwindReserver, orc::LLILCCompiler(*TM));
+        UnwindReserver,
+        orc::LLILCCompiler(*TM, Context.Options->DoInsertStatepoints,
+                           JitOptions.IsCodeQualityMethod, DisableFastISel));
 
     // Now jit the method.
     if (Context.Options->DumpLevel == DumpLevel::VERBOSE) {
@@ -338,6 +387,7 @@ CorJitResult LLILCJit::compileMethod(ICorJitInfo *JitInfo,
              << " using LLILCJit\n";
     }
     bool HasMethod = this->readMethod(&Context);
+    bool IsDeclined = false;
 
 #ifndef FEATURE_VERIFICATION
     bool IsImportOnly = (Context.Flags & CORJIT_FLG_IMPORT_ONLY) != 0;
@@ -360,13 +410,39 @@ CorJitResult LLILCJit::compileMethod(ICorJitInfo *JitInfo,
                << "\n";
         Context.CurrentModule->dump();
       }
-      if (Context.Options->DoInsertStatepoints) {
+
+      // Check the budget after each IR phase. Code generation can't be
+      // interrupted, so the last check is made before it starts.
+      Context.estimateIRMemory();
+      HasMethod = !Context.isOverBudget("reader");
+      if (HasMethod) {
+        HasMethod = selectStrategy(&Context);
+        IsDeclined = !HasMethod;
+      }
+      if (HasMethod && (Context.Options->DoEarlyOptimization ||
+                        Context.Options->DoVectorize ||
+                        Context.Options->DoLoopCloning)) {
+        optimizeMethod(&Context);
+        Context.estimateIRMemory();
+        HasMethod = !Context.isOverBudget("optimization");
+      }
+      if (HasMethod && Context.Options->DoInsertStatepoints) {
         // If using Precise GC, run the GC-Safepoint insertion
         // and lowering passes before generating code.
-        legacy::PassManager Passes;
-        Passes.add(createPlaceSafepointsPass());
-        Passes.add(createRewriteStatepointsForGCPass());
-        Passes.run(*M);
+        insertStatepoints(&Context);
+        Context.estimateIRMemory();
+        HasMethod = !Context.isOverBudget("statepoint insertion");
+      }
+    }
+
+    if (HasMethod) {
+      CodeQualityInfo CodeQuality;
+      if (JitOptions.IsCodeQualityMethod) {
+        Function *Method = M->getFunction(Context.MethodName);
+        if (Method != nullptr) {
+          CodeQuality.recordIR(Context, *Method);
+        }
+        Context.CodeQuality = &CodeQuality;
       }
 
       // Use a custom resolver that will tell the dynamic linker to skip
@@ -383,10 +459,14 @@ CorJitResult LLILCJit::compileMethod(ICorJitInfo *JitInfo,
       // TODO: ColdCodeSize, or separated code, is not enabled or included.
       *NativeSizeOfCode = Context.HotCodeSize + Context.ReadOnlyDataSize;
       if (JitOptions.IsCodeRangeMethod) {
+        double CompileSeconds =
+            TimeRecord::getCurrentTime(false).getWallTime() -
+            StartTime.getWallTime();
         errs() << "LLILC compiled: "
                << ", Entry = " << *NativeEntry
                << ", End = " << (*NativeEntry + *NativeSizeOfCode)
                << ", size = " << *NativeSizeOfCode
+               << ", time = " << (uint64_t)(CompileSeconds * 1000000) << " us"
                << " method = " << Context.MethodName << '\n';
       }
 
@@ -402,14 +482,25 @@ CorJitResult LLILCJit::compileMethod(ICorJitInfo *JitInfo,
                                   &GcInfoAllocator);
       GcInfoEmitter.emitGCInfo();
 
-      // Dump out any enabled timing info.
-      TimerGroup::printAll(errs());
+      if (JitOptions.IsCodeQualityMethod) {
+        CodeQuality.print(errs(), Context);
+        Context.CodeQuality = nullptr;
+      }
+
+      // Dump out any enabled timing info. Printing takes the global timer
+      // group lock, so skip it unless timing was asked for.
+      if (TimePassesIsEnabled) {
+        TimerGroup::printAll(errs());
+      }
 
       // Give the jit layers a chance to free resources.
       Compiler.removeModuleSet(HandleSet);
 
       // Tell the CLR that we've successfully generated code for this method.
       Result = CORJIT_OK;
+    } else if (IsDeclined || (Context.BudgetExceededPhase != nullptr)) {
+      // Let the EE fall back to the default jit.
+      Result = CORJIT_SKIPPED;
     }
 
     // Clean up a bit
@@ -448,6 +539,11 @@ LLILCJitContext::getModuleForMethod(CORINFO_METHOD_INFO *MethodInfo) {
   char *BitcodePath = getenv("BITCODE_PATH");
 
   if (BitcodePath != nullptr) {
+    // Side-loaded IR may carry module-level inline asm.
+    static std::once_flag AsmParserInitialized;
+    std::call_once(AsmParserInitialized,
+                   []() { InitializeNativeTargetAsmParser(); });
+
     SMDiagnostic Err;
     std::string Path = std::string(BitcodePath);
 
@@ -476,6 +572,59 @@ LLILCJitContext::getModuleForMethod(CORINFO_METHOD_INFO *MethodInfo) {
   return std::move(M);
 }
 
+void LLILCJitContext::estimateIRMemory() {
+  // LLVM doesn't account for the memory behind a module, so estimate it from
+  // the number and size of the values it holds.
+  size_t Bytes = 0;
+  for (const GlobalVariable &Global : CurrentModule->globals()) {
+    Bytes += sizeof(GlobalVariable) + Global.getName().size();
+  }
+  for (const Function &F : *CurrentModule) {
+    Bytes += sizeof(Function);
+    for (const BasicBlock &Block : F) {
+      Bytes += estimateIRMemory(Block);
+    }
+  }
+  IRMemory = Bytes;
+}
+
+size_t LLILCJitContext::estimateIRMemory(const BasicBlock &Block) {
+  size_t Bytes = sizeof(BasicBlock);
+  for (const Instruction &Instr : Block) {
+    Bytes += sizeof(Instruction) + Instr.getNumOperands() * sizeof(Use);
+  }
+  return Bytes;
+}
+
+size_t TypeTranslationInfo::estimateSavedBytes() const {
+  return (CollapsedFields * sizeof(Type *)) +
+         (UntypedReferences * (sizeof(StructType) + sizeof(PointerType)));
+}
+
+bool LLILCJitContext::isOverBudget(const char *Phase) {
+  size_t Memory = ReaderMemory + IRMemory;
+  if ((Options->MemoryBudget != 0) && (Memory > Options->MemoryBudget)) {
+    errs() << "LLILC skipped " << MethodName << ": memory budget exceeded in "
+           << Phase << " (" << (uint64_t)Memory << " bytes)\n";
+    BudgetExceededPhase = Phase;
+    return true;
+  }
+
+  if (Options->TimeBudget != 0) {
+    double Seconds = TimeRecord::getCurrentTime(false).getWallTime() -
+                     StartTime.getWallTime();
+    uint64_t Milliseconds = (uint64_t)(Seconds * 1000);
+    if (Milliseconds > Options->TimeBudget) {
+      errs() << "LLILC skipped " << MethodName << ": time budget exceeded in "
+             << Phase << " (" << Milliseconds << " ms)\n";
+      BudgetExceededPhase = Phase;
+      return true;
+    }
+  }
+
+  return false;
+}
+
 // Read method MSIL and construct LLVM bitcode
 bool LLILCJit::readMethod(LLILCJitContext *JitContext) {
   if (JitContext->HasLoadedBitCode) {
@@ -490,20 +639,48 @@ bool LLILCJit::readMethod(LLILCJitContext *JitContext) {
   try {
     GenIR Reader(JitContext);
     Reader.msilToIR();
+    JitContext->EEQueries = Reader.getEEQueryCounts();
   } catch (NotYetImplementedException &Nyi) {
     if (DumpLevel >= ::DumpLevel::SUMMARY) {
       errs() << "Failed to read " << FuncName << '[' << Nyi.reason() << "]\n";
     }
     return false;
+  } catch (CompileBudgetExceededException &) {
+    // Already logged by isOverBudget.
+    return false;
   }
 
-  bool IsOk = !verifyModule(*JitContext->CurrentModule, &dbgs());
+  // The reader's allocations are not used once it has finished, so later
+  // budget checks only count the IR.
+  JitContext->ReaderMemory = 0;
+
+  // Minimal compiles trust the reader and skip the verifier, except in
+  // checked builds.
+  bool Verify = !JitContext->Options->DoMinimalCompile;
+#ifndef NDEBUG
+  Verify = true;
+#endif // !NDEBUG
+  bool IsOk = !Verify || !verifyModule(*JitContext->CurrentModule, &dbgs());
   assert(IsOk && "verification failed");
 
   if (IsOk) {
     if (DumpLevel >= ::DumpLevel::SUMMARY) {
       errs() << "Successfully read " << FuncName << '\n';
     }
+    const TypeTranslationInfo &Types = JitContext->TypeTranslation;
+    if ((DumpLevel >= ::DumpLevel::SUMMARY) && (Types.CompactClasses > 0)) {
+      errs() << "Type translation for " << FuncName << ": "
+             << (uint64_t)(Types.Seconds * 1000000) << " us, "
+             << Types.CompactClasses << " compact classes, "
+             << Types.CollapsedFields << " fields collapsed, "
+             << Types.UntypedReferences << " references typed as Object, ~"
+             << (uint64_t)Types.estimateSavedBytes() << " bytes saved\n";
+    }
+    if (DumpLevel >= ::DumpLevel::SUMMARY) {
+      const EEQueryCounts &Queries = JitContext->EEQueries;
+      errs() << "EE queries for " << FuncName << ": " << Queries.Queries
+             << " made, " << Queries.EECalls << " passed on to the EE\n";
+    }
   } else {
     if (DumpLevel >= ::DumpLevel::SUMMARY) {
       errs() << "Failed to read " << FuncName << "[verification error]\n";
@@ -518,11 +695,187 @@ bool LLILCJit::readMethod(LLILCJitContext *JitContext) {
   return IsOk;
 }
 
+// Measure the method's IR and pick a compile strategy for it. Large methods
+// get the minimal-latency profile, and methods over the configured maximum
+// are declined so that the EE's default jit compiles them.
+bool LLILCJit::selectStrategy(LLILCJitContext *JitContext) {
+  MethodSize &Size = JitContext->IRSize;
+  Size = MethodSize();
+  Size.EHRegions = JitContext->MethodInfo->EHcount;
+  for (const Function &F : *JitContext->CurrentModule) {
+    for (const BasicBlock &Block : F) {
+      ++Size.Blocks;
+      for (const Instruction &Instr : Block) {
+        ++Size.Instructions;
+        if (isa<AllocaInst>(Instr)) {
+          ++Size.Allocas;
+        } else if ((isa<CallInst>(Instr) || isa<InvokeInst>(Instr)) &&
+                   !isa<IntrinsicInst>(Instr)) {
+          ++Size.Safepoints;
+        }
+      }
+    }
+  }
+
+  ::Options *Options = JitContext->Options;
+  bool IsDeclined = (Options->MaxMethodInstructions != 0) &&
+                    (Size.Instructions > Options->MaxMethodInstructions);
+  bool IsLarge = (Size.Instructions > Options->LargeMethodInstructions) ||
+                 (Size.Blocks > Options->LargeMethodBlocks);
+
+  if (IsLarge && !IsDeclined && !Options->DoMinimalCompile) {
+    // Too big for the optional IR pipelines and the greedy register allocator
+    // to pay off. Ngen and ReadyToRun keep their code generation level, which
+    // they need for the form of calls they emit.
+    Options->DoMinimalCompile = true;
+    Options->DoEarlyOptimization = false;
+    Options->DoVectorize = false;
+    Options->DoLoopCloning = false;
+    if ((JitContext->Flags & (CORJIT_FLG_PREJIT | CORJIT_FLG_READYTORUN)) ==
+        0) {
+      JitContext->TM->setOptLevel(CodeGenOpt::None);
+    }
+  }
+
+  if (IsDeclined || (Options->DumpLevel >= ::DumpLevel::SUMMARY)) {
+    const char *Strategy =
+        IsDeclined ? "declined"
+                   : (Options->DoMinimalCompile ? "minimal" : "full");
+    errs() << "IR size of " << JitContext->MethodName
+           << ": instructions = " << Size.Instructions
+           << ", blocks = " << Size.Blocks << ", allocas = " << Size.Allocas
+           << ", EH regions = " << Size.EHRegions
+           << ", safepoints = " << Size.Safepoints
+           << ", strategy = " << Strategy
+           << " (large above " << Options->LargeMethodInstructions
+           << " instructions or " << Options->LargeMethodBlocks << " blocks";
+    if (Options->MaxMethodInstructions != 0) {
+      errs() << ", declined above " << Options->MaxMethodInstructions
+             << " instructions";
+    }
+    errs() << ")\n";
+  }
+
+  return !IsDeclined;
+}
+
+// Run the requested optimizations. The scalar passes up front also put loops
+// over managed arrays into a shape the loop passes can handle: locals
+// promoted to SSA, invariant array lengths hoisted, and bounds checks that
+// the loop condition already implies folded away. This runs before
+// statepoint rewriting, while GC pointers are still plain values in the
+// managed address space; optimizing here means fewer values are live across
+// safepoints, and so fewer relocations and spills later.
+void LLILCJit::optimizeMethod(LLILCJitContext *JitContext) {
+  initializeScalarOptsOnce();
+  TargetMachine *TM = JitContext->TM;
+  legacy::PassManager Passes;
+  Passes.add(createTargetTransformInfoWrapperPass(TM->getTargetIRAnalysis()));
+  Passes.add(createSROAPass());
+  Passes.add(createEarlyCSEPass());
+  Passes.add(createCFGSimplificationPass());
+  Passes.add(createInstructionCombiningPass());
+  if (JitContext->Options->DoEarlyOptimization) {
+    Passes.add(createJumpThreadingPass());
+    Passes.add(createCorrelatedValuePropagationPass());
+    Passes.add(createReassociatePass());
+    Passes.add(createSCCPPass());
+    Passes.add(createInstructionCombiningPass());
+    Passes.add(createCFGSimplificationPass());
+  }
+  Passes.add(createLoopRotatePass());
+  Passes.add(createLICMPass());
+  if (JitContext->Options->DoLoopCloning) {
+    // Version loops on invariant conditions such as the array null check,
+    // keeping the original loop as the fallback.
+    Passes.add(createLoopUnswitchPass());
+  }
+  Passes.add(createIndVarSimplifyPass());
+  Passes.add(createCorrelatedValuePropagationPass());
+  Passes.add(createGVNPass());
+  Passes.add(createCFGSimplificationPass());
+  if (JitContext->Options->DoLoopCloning) {
+    // Split loops whose bounds checks can't be proven statically into a main
+    // loop, entered after one upfront range check, that runs with no bounds
+    // checks, plus pre- and post-loops that keep them.
+    Passes.add(createInductiveRangeCheckEliminationPass());
+    Passes.add(createInstructionCombiningPass());
+    Passes.add(createCFGSimplificationPass());
+  }
+  if (JitContext->Options->DoVectorize) {
+    Passes.add(createLoopVectorizePass());
+    Passes.add(createSLPVectorizerPass());
+    Passes.add(createInstructionCombiningPass());
+    Passes.add(createCFGSimplificationPass());
+  }
+  if (JitContext->Options->DoEarlyOptimization) {
+    Passes.add(createDeadStoreEliminationPass());
+    Passes.add(createAggressiveDCEPass());
+    Passes.add(createCFGSimplificationPass());
+  }
+  Passes.run(*JitContext->CurrentModule);
+}
+
+// Count the gc.relocate calls in a module.
+static unsigned countRelocates(Module &M) {
+  unsigned NumRelocates = 0;
+  for (Function &F : M) {
+    for (BasicBlock &BB : F) {
+      for (Instruction &I : BB) {
+        if (auto *Call = dyn_cast<IntrinsicInst>(&I)) {
+          if (Call->getIntrinsicID() == Intrinsic::experimental_gc_relocate) {
+            ++NumRelocates;
+          }
+        }
+      }
+    }
+  }
+  return NumRelocates;
+}
+
+void LLILCJit::insertStatepoints(LLILCJitContext *JitContext) {
+  initializeScalarOptsOnce();
+  Module &M = *JitContext->CurrentModule;
+  legacy::PassManager Passes;
+  Passes.add(createPlaceSafepointsPass());
+  Passes.add(createRewriteStatepointsForGCPass());
+  Passes.run(M);
+
+  if ((JitContext->Options->OptLevel == ::OptLevel::DEBUG_CODE) ||
+      JitContext->Options->DoMinimalCompile) {
+    return;
+  }
+
+  // The rewrite relocates each live GC value separately at every statepoint
+  // and leaves the surrounding IR untouched. Clean up: common identical
+  // relocates, fold address computations through them, and drop relocates
+  // and other values left dead.
+  bool Summarize = JitContext->Options->DumpLevel >= ::DumpLevel::SUMMARY;
+  unsigned RelocatesBefore = Summarize ? countRelocates(M) : 0;
+
+  legacy::PassManager CleanupPasses;
+  CleanupPasses.add(createEarlyCSEPass());
+  CleanupPasses.add(createInstructionCombiningPass());
+  CleanupPasses.add(createAggressiveDCEPass());
+  CleanupPasses.add(createCFGSimplificationPass());
+  CleanupPasses.run(M);
+
+  if (Summarize) {
+    errs() << "Relocates for " << JitContext->MethodName << ": "
+           << RelocatesBefore << " before cleanup, " << countRelocates(M)
+           << " after\n";
+  }
+}
+
 // Notification from the runtime that any caches should be cleaned up.
-void LLILCJit::clearCache() { return; }
+// Each thread clears its own caches at the start of its next compile.
+void LLILCJit::clearCache() {
+  CacheGeneration.fetch_add(1, std::memory_order_release);
+}
 
-// Notify runtime if we have something to clean up
-BOOL LLILCJit::isCacheCleanupRequired() { return FALSE; }
+// Notify runtime if we have something to clean up. Every compile caches
+// types and EE answers by class and field handle.
+BOOL LLILCJit::isCacheCleanupRequired() { return TRUE; }
 
 // Verify the JIT/EE interface identifier.
 void LLILCJit::getVersionIdentifier(GUID *VersionIdentifier) {
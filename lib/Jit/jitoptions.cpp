@@ -41,6 +41,22 @@ MethodSet JitOptions::BreakMethodSet;
 MethodSet JitOptions::MSILMethodSet;
 MethodSet JitOptions::LLVMMethodSet;
 MethodSet JitOptions::CodeRangeMethodSet;
+MethodSet JitOptions::CodeQualityMethodSet;
+MethodSet JitOptions::MinOptsMethodSet;
+
+/// IL size above which a method is compiled with the minimal profile. This
+/// matches the size at which RyuJIT switches to MinOpts.
+static const uint32_t MinimalCompileILSize = 60000;
+
+/// IR size above which a method is compiled with the minimal profile once it
+/// has been read. These match the instruction and block counts at which
+/// RyuJIT switches to MinOpts.
+static const uint32_t DefaultLargeMethodInstructions = 20000;
+static const uint32_t DefaultLargeMethodBlocks = 2000;
+
+/// Number of fields a class must declare, beyond those of its base classes,
+/// to be given a compact layout.
+static const uint32_t DefaultCompactClassFields = 64;
 
 template <typename UTF16CharT>
 char16_t *getStringConfigValue(ICorJitInfo *CorInfo, const UTF16CharT *Name) {
@@ -72,11 +88,34 @@ JitOptions::JitOptions(LLILCJitContext &Context) {
 
   DoSIMDIntrinsic = queryDoSIMDIntrinsic(Context);
 
+  // Set whether to compile for latency rather than code quality.
+  DoMinimalCompile = queryDoMinimalCompile(Context);
+
+  // IR optimizations are skipped for debug code and minimal compiles.
+  bool MayOptimize = (OptLevel != ::OptLevel::DEBUG_CODE) && !DoMinimalCompile;
+
+  // Set whether to run the vectorizers.
+  DoVectorize = MayOptimize && queryDoVectorize(Context);
+
+  // Set whether to clone loops to remove range checks.
+  DoLoopCloning = MayOptimize && queryDoLoopCloning(Context);
+
+  // Set whether to run the scalar optimizer before safepoint placement.
+  DoEarlyOptimization = MayOptimize && queryDoEarlyOptimization(Context);
+
   // Set whether to do tail call opt.
   DoTailCallOpt = queryDoTailCallOpt(Context);
 
   LogGcInfo = queryLogGcInfo(Context);
 
+  // Set the resource limits for a single compile.
+  MemoryBudget = queryMemoryBudget(Context);
+  TimeBudget = queryTimeBudget(Context);
+  queryMethodSizeLimits(Context, *this);
+
+  // Set the size at which classes get compact LLVM types.
+  CompactClassFields = queryCompactClassFields(Context);
+
   // Set whether to insert failfast in exception handlers.
   ExecuteHandlers = queryExecuteHandlers(Context);
 
@@ -85,6 +124,7 @@ JitOptions::JitOptions(LLILCJitContext &Context) {
   IsMSILDumpMethod = queryIsMSILDumpMethod(Context);
   IsLLVMDumpMethod = queryIsLLVMDumpMethod(Context);
   IsCodeRangeMethod = queryIsCodeRangeMethod(Context);
+  IsCodeQualityMethod = queryIsCodeQualityMethod(Context);
 
   if (IsAltJit) {
     PreferredIntrinsicSIMDVectorLength = 0;
@@ -208,6 +248,11 @@ bool JitOptions::queryIsCodeRangeMethod(LLILCJitContext &JitContext) {
                         (const char16_t *)UTF16("AltJitCodeRangeDump"));
 }
 
+bool JitOptions::queryIsCodeQualityMethod(LLILCJitContext &JitContext) {
+  return queryMethodSet(JitContext, CodeQualityMethodSet,
+                        (const char16_t *)UTF16("AltJitCodeQualityDump"));
+}
+
 bool JitOptions::queryMethodSet(LLILCJitContext &JitContext, MethodSet &TheSet,
                                 const char16_t *Name) {
   if (!TheSet.isInitialized()) {
@@ -224,6 +269,11 @@ bool JitOptions::queryMethodSet(LLILCJitContext &JitContext, MethodSet &TheSet,
     }
   }
 
+  // Most sets are empty; don't ask the EE for the method name for those.
+  if (TheSet.isEmpty()) {
+    return false;
+  }
+
   const char *ClassName = nullptr;
   const char *MethodName = nullptr;
   MethodName =
@@ -269,6 +319,43 @@ bool JitOptions::queryDoSIMDIntrinsic(LLILCJitContext &Context) {
                               (const char16_t *)UTF16("SIMDINTRINSIC"));
 }
 
+// Determine if loops should be vectorized.
+bool JitOptions::queryDoVectorize(LLILCJitContext &Context) {
+  return queryNonNullNonEmpty(Context, (const char16_t *)UTF16("JitVectorize"));
+}
+
+// Determine if loops should be cloned to remove range checks.
+bool JitOptions::queryDoLoopCloning(LLILCJitContext &Context) {
+  return queryNonNullNonEmpty(Context, (const char16_t *)UTF16("JitLoopClone"));
+}
+
+// Determine if IR should be optimized before safepoint placement.
+bool JitOptions::queryDoEarlyOptimization(LLILCJitContext &Context) {
+  return queryNonNullNonEmpty(Context, (const char16_t *)UTF16("JitEarlyOpt"));
+}
+
+bool JitOptions::queryDoMinimalCompile(LLILCJitContext &Context) {
+  if ((Context.Flags & CORJIT_FLG_MIN_OPT) != 0) {
+    return true;
+  }
+
+  if (Context.MethodInfo->ILCodeSize > MinimalCompileILSize) {
+    return true;
+  }
+
+  // Class constructors run exactly once.
+  const uint32_t ClassCtorAttribs =
+      CORINFO_FLG_CONSTRUCTOR | CORINFO_FLG_STATIC;
+  uint32_t Attribs =
+      Context.JitInfo->getMethodAttribs(Context.MethodInfo->ftn);
+  if ((Attribs & ClassCtorAttribs) == ClassCtorAttribs) {
+    return true;
+  }
+
+  return queryMethodSet(Context, MinOptsMethodSet,
+                        (const char16_t *)UTF16("AltJitMinOpts"));
+}
+
 OptLevel JitOptions::queryOptLevel(LLILCJitContext &Context) {
   ::OptLevel JitOptLevel = ::OptLevel::INVALID;
   // Currently we only check for the debug flag but this will be extended
@@ -281,3 +368,49 @@ OptLevel JitOptions::queryOptLevel(LLILCJitContext &Context) {
 }
 
 JitOptions::~JitOptions() {}
+
+uint64_t JitOptions::queryMemoryBudget(LLILCJitContext &Context) {
+  uint64_t Megabytes =
+      queryUnsigned(Context, (const char16_t *)UTF16("AltJitMemoryBudget"), 0);
+  return Megabytes << 20;
+}
+
+uint32_t JitOptions::queryTimeBudget(LLILCJitContext &Context) {
+  return queryUnsigned(Context, (const char16_t *)UTF16("AltJitTimeBudget"),
+                       0);
+}
+
+void JitOptions::queryMethodSizeLimits(LLILCJitContext &Context,
+                                       ::Options &Opts) {
+  Opts.LargeMethodInstructions = queryUnsigned(
+      Context, (const char16_t *)UTF16("AltJitLargeMethodInstrs"),
+      DefaultLargeMethodInstructions);
+  Opts.LargeMethodBlocks = queryUnsigned(
+      Context, (const char16_t *)UTF16("AltJitLargeMethodBlocks"),
+      DefaultLargeMethodBlocks);
+  Opts.MaxMethodInstructions = queryUnsigned(
+      Context, (const char16_t *)UTF16("AltJitMaxMethodInstrs"), 0);
+}
+
+uint32_t JitOptions::queryCompactClassFields(LLILCJitContext &Context) {
+  return queryUnsigned(Context,
+                       (const char16_t *)UTF16("AltJitCompactClassFields"),
+                       DefaultCompactClassFields);
+}
+
+uint32_t JitOptions::queryUnsigned(LLILCJitContext &JitContext,
+                                   const char16_t *Name, uint32_t Default) {
+  char16_t *ConfigStr = getStringConfigValue(JitContext.JitInfo, Name);
+  if (ConfigStr == nullptr) {
+    return Default;
+  }
+  std::unique_ptr<std::string> ConfigUtf8 = Convert::utf16ToUtf8(ConfigStr);
+  freeStringConfigValue(JitContext.JitInfo, ConfigStr);
+
+  char *End = nullptr;
+  unsigned long Value = strtoul(ConfigUtf8->c_str(), &End, 10);
+  if (ConfigUtf8->empty() || *End != '\0') {
+    return Default;
+  }
+  return (uint32_t)Value;
+}
@@ -99,13 +99,11 @@ void MethodSet::insert(unique_ptr<string> Ups) {
     MId = MethodID::parse(S, I);
   }
 
-  // This write should be atomic, delete if we're not the first.
-  llvm::sys::cas_flag F = llvm::sys::CompareAndSwap(
-      (llvm::sys::cas_flag *)&(this->Initialized), 0x1, 0x0);
-  if (F != 0x0) {
+  // Publish the list, or delete it if another thread got there first.
+  std::list<MethodID> *Expected = nullptr;
+  if (!this->MethodIDList.compare_exchange_strong(Expected, MIdList,
+                                                   std::memory_order_acq_rel)) {
     delete MIdList;
-  } else {
-    this->MethodIDList = MIdList;
   }
 }
 
@@ -124,8 +122,10 @@ bool MethodSet::contains(const char *MethodName, const char *ClassName,
   string StrClassName = ClassName ? ClassName : "";
   string StrMethodName = MethodName ? MethodName : "";
 
-  auto Begin = this->MethodIDList->begin();
-  auto End = this->MethodIDList->end();
+  std::list<MethodID> *List =
+      this->MethodIDList.load(std::memory_order_acquire);
+  auto Begin = List->begin();
+  auto End = List->end();
 
   for (auto P = Begin; P != End; ++P) { // P => "pattern"
 
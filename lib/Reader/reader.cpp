@@ -31,6 +31,7 @@
 #include <climits>
 #include <algorithm>
 #include <list>
+#include <tuple>
 
 extern int _cdecl dbPrint(const char *Form, ...);
 
@@ -441,8 +442,35 @@ void ReaderBase::printMSIL(uint8_t *Buf, uint32_t StartOffset,
 //
 //////////////////////////////////////////////////////////////////////////
 
+/// \brief Answer an EE query from a cache, asking the EE on a miss.
+///
+/// \param Cache The cache for this kind of query, or nullptr if the query
+/// must go to the EE.
+/// \param Key The handle the query is about.
+/// \param Counts Counts of queries made and passed on to the EE.
+/// \param AskEE Function that passes the query on to the EE.
+/// \returns The answer to the query.
+template <typename KeyT, typename ValueT, typename QueryT>
+static ValueT cachedEEQuery(std::map<KeyT, ValueT> *Cache, KeyT Key,
+                            EEQueryCounts &Counts, QueryT AskEE) {
+  Counts.Queries++;
+  if (Cache != nullptr) {
+    auto Found = Cache->find(Key);
+    if (Found != Cache->end()) {
+      return Found->second;
+    }
+  }
+
+  Counts.EECalls++;
+  ValueT Value = AskEE();
+  if (Cache != nullptr) {
+    Cache->insert(std::make_pair(Key, Value));
+  }
+  return Value;
+}
+
 bool ReaderBase::isPrimitiveType(CORINFO_CLASS_HANDLE Handle) {
-  return isPrimitiveType(JitInfo->asCorInfoType((CORINFO_CLASS_HANDLE)Handle));
+  return isPrimitiveType(getClassType(Handle));
 }
 
 bool ReaderBase::isPrimitiveType(CorInfoType CorInfoType) {
@@ -454,7 +482,12 @@ void *ReaderBase::getHelperDescr(CorInfoHelpFunc HelpFuncId, bool *IsIndirect) {
   void *HelperHandle, *IndirectHelperHandle;
 
   ASSERTNR(IsIndirect != nullptr);
-  HelperHandle = JitInfo->getHelperFtn(HelpFuncId, &IndirectHelperHandle);
+  std::tie(HelperHandle, IndirectHelperHandle) = cachedEEQuery(
+      EECache ? &EECache->Helpers : nullptr, HelpFuncId, EEQueries, [&] {
+        void *Indirect = nullptr;
+        void *Direct = JitInfo->getHelperFtn(HelpFuncId, &Indirect);
+        return std::make_pair(Direct, Indirect);
+      });
   if (HelperHandle != nullptr) {
     *IsIndirect = false;
     return HelperHandle;
@@ -521,11 +554,11 @@ uint32_t ReaderBase::getCurrentMethodHash(void) {
 }
 
 uint32_t ReaderBase::getCurrentMethodAttribs(void) {
-  return JitInfo->getMethodAttribs(getCurrentMethodHandle());
+  return getMethodAttribs(getCurrentMethodHandle());
 }
 
 const char *ReaderBase::getCurrentMethodName(const char **ModuleName) {
-  return JitInfo->getMethodName(getCurrentMethodHandle(), ModuleName);
+  return getMethodName(getCurrentMethodHandle(), ModuleName);
 }
 
 mdToken ReaderBase::getMethodDefFromMethod(CORINFO_METHOD_HANDLE Handle) {
@@ -605,7 +638,7 @@ GCLayout *ReaderBase::getClassGCLayout(CORINFO_CLASS_HANDLE Class) {
   // is one byte for every sizeof(void*) slot in the valueclass.
   // Note that we round this computation up.
   const uint32_t PointerSize = getPointerByteSize();
-  const uint32_t ClassSize = JitInfo->getClassSize(Class);
+  const uint32_t ClassSize = getClassSize(Class);
   const uint32_t GcLayoutSize = ((ClassSize + PointerSize - 1) / PointerSize);
 
   // Our internal data structures prepend the number of GC pointers
@@ -638,11 +671,20 @@ bool ReaderBase::classHasGCPointers(CORINFO_CLASS_HANDLE Class) {
 }
 
 uint32_t ReaderBase::getClassAttribs(CORINFO_CLASS_HANDLE Class) {
-  return JitInfo->getClassAttribs(Class);
+  return cachedEEQuery(EECache ? &EECache->ClassAttribs : nullptr, Class,
+                       EEQueries,
+                       [&] { return JitInfo->getClassAttribs(Class); });
 }
 
 uint32_t ReaderBase::getClassSize(CORINFO_CLASS_HANDLE Class) {
-  return JitInfo->getClassSize(Class);
+  return cachedEEQuery(EECache ? &EECache->ClassSizes : nullptr, Class,
+                       EEQueries, [&] { return JitInfo->getClassSize(Class); });
+}
+
+bool ReaderBase::isValueClass(CORINFO_CLASS_HANDLE Class) {
+  return cachedEEQuery(EECache ? &EECache->ValueClasses : nullptr, Class,
+                       EEQueries,
+                       [&] { return JitInfo->isValueClass(Class) != FALSE; });
 }
 
 uint32_t ReaderBase::getClassAlignmentRequirement(CORINFO_CLASS_HANDLE Class) {
@@ -682,7 +724,9 @@ ReaderBase::getMinimumClassAlignment(CORINFO_CLASS_HANDLE Class,
 }
 
 CorInfoType ReaderBase::getClassType(CORINFO_CLASS_HANDLE Class) {
-  return JitInfo->asCorInfoType(Class);
+  return cachedEEQuery(EECache ? &EECache->ClassTypes : nullptr, Class,
+                       EEQueries,
+                       [&] { return JitInfo->asCorInfoType(Class); });
 }
 
 // Size and pRetSig are 0/nullptr if type is non-value or primitive.
@@ -695,7 +739,7 @@ void ReaderBase::getClassType(CORINFO_CLASS_HANDLE Class, uint32_t ClassAttribs,
     *Size = 0;
   } else if (isPrimitiveType(Class)) {
     // If primitive value type then create temp of that type
-    *CorInfoType = JitInfo->asCorInfoType(Class);
+    *CorInfoType = getClassType(Class);
     *Size = 0;
   } else {
     // else class is non-primitive value class, a multibyte
@@ -763,7 +807,24 @@ CorInfoType ReaderBase::getFieldType(
     CORINFO_FIELD_HANDLE Field, CORINFO_CLASS_HANDLE *Class,
     CORINFO_CLASS_HANDLE Owner /* optional: for verification */
     ) {
-  return JitInfo->getFieldType(Field, Class, Owner);
+  // The answer depends on the owner when there is one, so only cache the
+  // owner-less queries.
+  if (Owner != nullptr) {
+    return JitInfo->getFieldType(Field, Class, Owner);
+  }
+
+  CorInfoType Type;
+  CORINFO_CLASS_HANDLE FieldClass;
+  std::tie(Type, FieldClass) = cachedEEQuery(
+      EECache ? &EECache->FieldTypes : nullptr, Field, EEQueries, [&] {
+        CORINFO_CLASS_HANDLE AnswerClass = nullptr;
+        CorInfoType AnswerType = JitInfo->getFieldType(Field, &AnswerClass);
+        return std::make_pair(AnswerType, AnswerClass);
+      });
+  if (Class != nullptr) {
+    *Class = FieldClass;
+  }
+  return Type;
 }
 
 uint32_t ReaderBase::getClassNumInstanceFields(CORINFO_CLASS_HANDLE Class) {
@@ -775,6 +836,59 @@ ReaderBase::getFieldInClass(CORINFO_CLASS_HANDLE Class, uint32_t Ordinal) {
   return JitInfo->getFieldInClass(Class, Ordinal);
 }
 
+const ClassFieldLayout &
+ReaderBase::getClassFieldLayout(CORINFO_CLASS_HANDLE Class) {
+  ASSERTNR(EECache != nullptr);
+  auto Found = EECache->ClassFieldLayouts.find(Class);
+  if (Found != EECache->ClassFieldLayouts.end()) {
+    return Found->second;
+  }
+
+  ClassFieldLayout Layout;
+  Layout.NumInstanceFields = getClassNumInstanceFields(Class);
+
+  // The instance field count includes the fields of all base classes. Take
+  // those out to get the number of fields this class declares. Value
+  // classes can't inherit fields.
+  uint32_t NumParentFields = 0;
+  const bool IsRefClass = !isValueClass(Class);
+  if (IsRefClass) {
+    CORINFO_CLASS_HANDLE ParentClass = JitInfo->getParentType(Class);
+    if (ParentClass != nullptr) {
+      NumParentFields = getClassFieldLayout(ParentClass).NumInstanceFields;
+    }
+  }
+  ASSERTNR(Layout.NumInstanceFields >= NumParentFields);
+  const uint32_t NumDeclaredFields = Layout.NumInstanceFields - NumParentFields;
+
+  for (uint32_t I = 0; I < NumDeclaredFields; I++) {
+    FieldLayoutEntry Field;
+    Field.Handle = getFieldInClass(Class, I);
+    if (Field.Handle == nullptr) {
+      // Likely a class that derives from System.__ComObject. See
+      // LLILC issue #557. We'll just have to cope with an incomplete
+      // picture of this type.
+      ASSERTNR(IsRefClass && "need to see all fields of value classes");
+      break;
+    }
+    Field.Offset = getFieldOffset(Field.Handle);
+    Field.Type = getFieldType(Field.Handle, &Field.Class);
+    Layout.Fields.push_back(Field);
+  }
+
+  // The EE gives the fields in somewhat arbitrary order, but clients want
+  // them in increasing order of offset.
+  std::sort(Layout.Fields.begin(), Layout.Fields.end(),
+            [](const FieldLayoutEntry &A, const FieldLayoutEntry &B) {
+              return std::make_pair(A.Offset, A.Handle) <
+                     std::make_pair(B.Offset, B.Handle);
+            });
+
+  auto Inserted = EECache->ClassFieldLayouts.insert(
+      std::make_pair(Class, std::move(Layout)));
+  return Inserted.first->second;
+}
+
 void ReaderBase::getFieldInfo(CORINFO_RESOLVED_TOKEN *ResolvedToken,
                               CORINFO_ACCESS_FLAGS AccessFlags,
                               CORINFO_FIELD_INFO *FieldInfo) {
@@ -912,18 +1026,36 @@ bool ReaderBase::pInvokeMarshalingRequired(CORINFO_METHOD_HANDLE Method,
 // method
 //
 
+// Find the name of the method handle. The EE owns the name strings, and
+// frees them along with dynamic methods it recycles once their code is no
+// longer referenced, so the names are only kept for the duration of this
+// compile.
 const char *ReaderBase::getMethodName(CORINFO_METHOD_HANDLE Method,
                                       const char **ModuleName) {
-  return JitInfo->getMethodName(Method, ModuleName);
-}
-
-// Find the attribs of the method handle
+  const char *Name;
+  const char *Module;
+  std::tie(Name, Module) = cachedEEQuery(&MethodNames, Method, EEQueries, [&] {
+    const char *AnswerModule = nullptr;
+    const char *AnswerName = JitInfo->getMethodName(Method, &AnswerModule);
+    return std::make_pair(AnswerName, AnswerModule);
+  });
+  if (ModuleName != nullptr) {
+    *ModuleName = Module;
+  }
+  return Name;
+}
+
+// Find the attribs of the method handle. Other compiles may change the
+// attribs of a method through setMethodAttribs, so the answers are only
+// kept for the duration of this compile.
 uint32_t ReaderBase::getMethodAttribs(CORINFO_METHOD_HANDLE Method) {
-  return JitInfo->getMethodAttribs(Method);
+  return cachedEEQuery(&MethodAttribs, Method, EEQueries,
+                       [&] { return JitInfo->getMethodAttribs(Method); });
 }
 
 void ReaderBase::setMethodAttribs(CORINFO_METHOD_HANDLE Method,
                                   CorInfoMethodRuntimeFlags Flags) {
+  MethodAttribs.erase(Method);
   return JitInfo->setMethodAttribs(Method, Flags);
 }
 
@@ -2353,6 +2485,7 @@ void ReaderBase::fgBuildPhase1(FlowGraphNode *Block, uint8_t *ILInput,
   LoadFtnToken = false;
   BranchesToVerify = nullptr;
   HasLocAlloc = false;
+  HasBackwardBranch = false;
   NextRegionTransitionOffset = NextOffset = CurrentOffset = 0;
 
   // Keep going through the buffer of bytecodes until we get to the end.
@@ -2438,6 +2571,10 @@ void ReaderBase::fgBuildPhase1(FlowGraphNode *Block, uint8_t *ILInput,
       TargetOffset = NextOffset + BranchOffset;
       CHECKTARGET(TargetOffset, ILInputSize);
 
+      if (TargetOffset <= CurrentOffset) {
+        HasBackwardBranch = true;
+      }
+
       if (Opcode == ReaderBaseNS::CEE_LEAVE ||
           Opcode == ReaderBaseNS::CEE_LEAVE_S) {
         TargetOffset =
@@ -2498,6 +2635,10 @@ void ReaderBase::fgBuildPhase1(FlowGraphNode *Block, uint8_t *ILInput,
         TargetOffset = NextOffset + BranchOffset;
         CHECKTARGET(TargetOffset, ILInputSize);
 
+        if (TargetOffset <= CurrentOffset) {
+          HasBackwardBranch = true;
+        }
+
         GraphNode = nullptr;
         fgAddNodeMSILOffset(&GraphNode, TargetOffset);
         ASSERTNR(GraphNode != nullptr);
@@ -4329,6 +4470,11 @@ ReaderBase::rdrCall(ReaderCallTargetData *Data, ReaderBaseNS::CallOpcode Opcode,
   bool CallCanSideEffect = true;
   bool MayThrow = true;
 
+  // Set when this is a delegate construction whose target can be recorded
+  // for later invokes of the delegate.
+  CORINFO_METHOD_HANDLE DelegateTarget = nullptr;
+  mdToken DelegateTargetToken = mdTokenNil;
+
   // TODO: readonly work for calls
 
   // Get the number of parameters from the signature (sig.NumArgs +
@@ -4595,6 +4741,28 @@ ReaderBase::rdrCall(ReaderCallTargetData *Data, ReaderBaseNS::CallOpcode Opcode,
           ASSERTNR(Data->hasThis());
           ASSERTNR(Data->isNewObj());
 
+          // Remember closed delegates over instance methods whose target is
+          // known exactly, so that invokes of the new delegate can call the
+          // target directly. The target is exact when the method is not
+          // virtual, or is virtual but final, however the method pointer
+          // was loaded. Static methods, virtual methods that can be
+          // overridden, methods on value classes (which would need an
+          // unboxing stub) and methods that need an instantiation argument
+          // are left to the generic path.
+          uint32_t TargetAttribs = getMethodAttribs(TargetMethod);
+          if (((TargetAttribs & CORINFO_FLG_STATIC) == 0) &&
+              (((TargetAttribs & CORINFO_FLG_VIRTUAL) == 0) ||
+               ((TargetAttribs & CORINFO_FLG_FINAL) != 0)) &&
+              ((getClassAttribs(getMethodClass(TargetMethod)) &
+                CORINFO_FLG_VALUECLASS) == 0)) {
+            CORINFO_SIG_INFO TargetSig;
+            getMethodSig(TargetMethod, &TargetSig);
+            if (!TargetSig.hasTypeArg()) {
+              DelegateTarget = TargetMethod;
+              DelegateTargetToken = Data->getLoadFtnToken();
+            }
+          }
+
           CORINFO_CLASS_HANDLE Class = Data->getClassHandle();
           CORINFO_METHOD_HANDLE Method = Data->getMethodHandle();
           ASSERTNR(CallInfo);
@@ -4814,7 +4982,7 @@ ReaderBase::rdrCall(ReaderCallTargetData *Data, ReaderBaseNS::CallOpcode Opcode,
         if (Class == nullptr) {
           // Default to (CORINFO_TYPE_CLASS, Object)
           Class = getBuiltinClass(CorInfoClassId::CLASSID_SYSTEM_OBJECT);
-        } else if (JitInfo->isValueClass(Class)) {
+        } else if (isValueClass(Class)) {
           CorType = CORINFO_TYPE_BYREF;
         }
 
@@ -4868,6 +5036,11 @@ ReaderBase::rdrCall(ReaderCallTargetData *Data, ReaderBaseNS::CallOpcode Opcode,
 
   if (Data->isNewObj()) {
     ReturnNode = rdrMakeNewObjReturnNode(Data, NewObjThisArg, ReturnNode);
+
+    if (DelegateTarget != nullptr) {
+      recordDelegateTarget(ReturnNode, DelegateTarget, DelegateTargetToken,
+                           Arguments[1]);
+    }
   }
 
   return ReturnNode;
@@ -5161,6 +5334,23 @@ ReaderBase::rdrGetDelegateInvokeTarget(ReaderCallTargetData *CallTargetData,
                                        IRNode **ThisPtr) {
   ASSERTNR(CallTargetData->hasThis());
 
+  // If the delegate was constructed in this method, call its target directly
+  // on the bound instance instead of loading both out of the delegate.
+  if ((Flags & CORJIT_FLG_READYTORUN) == 0) {
+    CORINFO_METHOD_HANDLE TargetMethod;
+    mdToken TargetMethodToken;
+    IRNode *TargetObject;
+    if (getDelegateTarget(*ThisPtr, &TargetMethod, &TargetMethodToken,
+                          &TargetObject)) {
+      *ThisPtr = TargetObject;
+      CallTargetData->NeedsNullCheck = true;
+      return rdrGetDirectCallTarget(
+          TargetMethod, TargetMethodToken,
+          CallTargetData->CallInfo.codePointerLookup,
+          CallTargetData->NeedsNullCheck, canMakeDirectCall(CallTargetData));
+    }
+  }
+
   IRNode *ThisPtrCopy, *AddressNode;
   dup(*ThisPtr, &ThisPtrCopy, ThisPtr);
 
@@ -7695,7 +7885,7 @@ void ReaderBase::msilToIR(void) {
         IsVerifiableCode ? (CORINFO_FLG_VERIFIABLE)
                          : CorInfoMethodRuntimeFlags(CORINFO_FLG_UNVERIFIABLE |
                                                      CORINFO_FLG_BAD_INLINEE);
-    JitInfo->setMethodAttribs(getCurrentMethodHandle(), VerificationFlags);
+    setMethodAttribs(getCurrentMethodHandle(), VerificationFlags);
   }
 
   //
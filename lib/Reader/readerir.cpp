@@ -30,6 +30,7 @@
 #include "llvm/Transforms/Utils/Local.h"   // for removeUnreachableBlocks
 #include "llvm/IR/DebugInfo.h"
 #include "llvm/IR/DebugInfoMetadata.h"
+#include <chrono>
 #include <cstdlib>
 #include <new>
 
@@ -237,10 +238,16 @@ EHRegion *rgnGetEntryRegion(EHRegion *TryRegion) {
 
 // Get memory that will be freed at end of reader
 
-void *GenIR::getTempMemory(size_t NumBytes) { return calloc(1, NumBytes); }
+void *GenIR::getTempMemory(size_t NumBytes) {
+  JitContext->ReaderMemory += NumBytes;
+  return calloc(1, NumBytes);
+}
 
 // Get memory that will persist after the reader
-void *GenIR::getProcMemory(size_t NumBytes) { return calloc(1, NumBytes); }
+void *GenIR::getProcMemory(size_t NumBytes) {
+  JitContext->ReaderMemory += NumBytes;
+  return calloc(1, NumBytes);
+}
 
 #pragma endregion
 
@@ -487,6 +494,10 @@ void GenIR::readerPostVisit() {
   // out the non-exceptional paths so as to better-optimize them).
   cloneFinallyBodies();
 
+  // Selector stores may have been removed above; the map is only needed while
+  // reading.
+  ContinuationStoreMap.clear();
+
   DBuilder->finalize();
 }
 
@@ -681,9 +692,68 @@ void GenIR::cloneFinallyBody(EHRegion *FinallyRegion) {
 
   // The switch in the exceptional path is no longer necessary and can just
   // branch to the cleanupret.
+  SwitchInst *CloneSwitch = cast_or_null<SwitchInst>(
+      static_cast<Value *>(ValueMap[ExitSwitch]));
+  LoadInst *SelectorLoad = cast<LoadInst>(ExitSwitch->getCondition());
   IRBuilder<> Builder(ExitSwitch);
   Builder.CreateBr(CleanupRetBlock);
   ExitSwitch->eraseFromParent();
+  SelectorLoad->eraseFromParent();
+
+  if (CloneSwitch != nullptr) {
+    removeRedundantFinallySelector(CloneSwitch);
+  }
+}
+
+void GenIR::removeRedundantFinallySelector(SwitchInst *ExitSwitch) {
+  // Cases other than the default that still target the unreachable block
+  // were for the exceptional continuation, which this path never takes.
+  BasicBlock *UnreachableBlock = ExitSwitch->getDefaultDest();
+  BasicBlock *OnlyContinuation = nullptr;
+  for (auto Case : ExitSwitch->cases()) {
+    BasicBlock *Continuation = Case.getCaseSuccessor();
+    if (Continuation == UnreachableBlock) {
+      continue;
+    }
+    if ((OnlyContinuation != nullptr) && (OnlyContinuation != Continuation)) {
+      // The finally really has multiple continuations; keep the selector.
+      return;
+    }
+    OnlyContinuation = Continuation;
+  }
+
+  if (OnlyContinuation == nullptr) {
+    // No leave ever reaches this finally non-exceptionally.
+    return;
+  }
+
+  // Branch straight to the only continuation.
+  LoadInst *SelectorLoad = cast<LoadInst>(ExitSwitch->getCondition());
+  Value *SelectorAddr = SelectorLoad->getPointerOperand();
+  BranchInst::Create(OnlyContinuation, ExitSwitch);
+  ExitSwitch->eraseFromParent();
+  SelectorLoad->eraseFromParent();
+
+  // With the selector no longer read, the stores at each leave are dead.
+  if (!SelectorAddr->use_empty()) {
+    for (User *U : SelectorAddr->users()) {
+      auto *Store = dyn_cast<StoreInst>(U);
+      if ((Store == nullptr) || (Store->getPointerOperand() != SelectorAddr)) {
+        return;
+      }
+    }
+  }
+  while (!SelectorAddr->use_empty()) {
+    cast<Instruction>(SelectorAddr->user_back())->eraseFromParent();
+  }
+
+  // The selector was made by createTemporary and may be the last alloca, so
+  // make sure later temporaries aren't placed after a deleted instruction.
+  Instruction *SelectorAlloca = cast<Instruction>(SelectorAddr);
+  if (AllocaInsertionPoint == SelectorAlloca) {
+    AllocaInsertionPoint = SelectorAlloca->getPrevNode();
+  }
+  SelectorAlloca->eraseFromParent();
 }
 
 bool GenIR::canExecuteHandler(BasicBlock &Handler) {
@@ -787,8 +857,10 @@ void GenIR::insertIRToKeepGenericContextAlive() {
     ContextLocalAddress = Arguments[MethodSignature.getTypeArgIndex()];
   }
 
-  GcFuncInfo->recordGenericsContext(cast<AllocaInst>(ContextLocalAddress),
-                                    ParamType);
+  if (recordsGcAllocas()) {
+    GcFuncInfo->recordGenericsContext(cast<AllocaInst>(ContextLocalAddress),
+                                      ParamType);
+  }
 
   // This method now requires a frame pointer.
   // TargetMachine *TM = JitContext->TM;
@@ -826,9 +898,17 @@ void GenIR::insertIRForSecurityObject() {
              (IRNode *)SecurityObjectAddress);
 
   LLVMBuilder->restoreIP(SavedInsertPoint);
-  GcFuncInfo->recordSecurityObject(cast<AllocaInst>(SecurityObjectAddress));
+  if (recordsGcAllocas()) {
+    GcFuncInfo->recordSecurityObject(cast<AllocaInst>(SecurityObjectAddress));
+  }
 }
 
+// Note on fast paths: the monitor helpers handed out by the EE for these ids
+// already are the inline-able variants - their entry is a thin-lock
+// compare-and-swap on the object header with the contended and recursive
+// cases out of line.  Inlining that CAS here would need the current thread's
+// managed id and the header bit layout, neither of which the jit interface
+// exposes, so the jit simply calls the helper.
 void GenIR::callMonitorHelper(bool IsEnter) {
   CorInfoHelpFunc HelperId;
   const uint32_t MethodFlags = getCurrentMethodAttribs();
@@ -948,10 +1028,18 @@ void GenIR::insertIRForUnmanagedCallFrame() {
 //
 //===----------------------------------------------------------------------===//
 
+bool GenIR::recordsGcAllocas() {
+  // Only precise GC reports stack slots to the runtime. Under conservative GC
+  // the runtime scans the whole frame, so GC allocas need no record, no
+  // up-front zero-initialization, and no localescape - which leaves them
+  // free to be promoted to SSA values.
+  return JitContext->Options->DoInsertStatepoints;
+}
+
 AllocaInst *GenIR::createAlloca(Type *T, Value *ArraySize, const Twine &Name) {
   AllocaInst *AllocaInst = LLVMBuilder->CreateAlloca(T, ArraySize, Name);
 
-  if (GcInfo::isGcType(T)) {
+  if (GcInfo::isGcType(T) && recordsGcAllocas()) {
     GcFuncInfo->recordGcAlloca(AllocaInst);
   }
 
@@ -1020,7 +1108,9 @@ void GenIR::createSym(uint32_t Num, bool IsAuto, CorInfoType CorType,
     // JIT\Methodical\ELEMENT_TYPE_IU\_il_relu_vfld.exe
     //  .locals (valuetype Test.AA pinned V_0)
     // where Test.AA is a struct containing a GC pointer.
-    GcFuncInfo->recordPinned(AllocaInst);
+    if (recordsGcAllocas()) {
+      GcFuncInfo->recordPinned(AllocaInst);
+    }
   }
 
   DIFile *Unit = DBuilder->createFile(LLILCDebugInfo.TheCU->getFilename(),
@@ -1095,7 +1185,7 @@ void GenIR::zeroInitLocals() {
   // Ensure all GC-Locals are recorded to be initialized
   // Regardless of isZeroInitLocals()
   for (const auto &LocalVar : LocalVars) {
-    if (GcInfo::isGcAllocation(LocalVar)) {
+    if (GcInfo::isGcAllocation(LocalVar) && recordsGcAllocas()) {
       assert(GcFuncInfo->hasRecord(cast<AllocaInst>(LocalVar)) &&
              "Missing GcAlloc Record");
     }
@@ -1746,6 +1836,10 @@ GenIR::getClassType(CORINFO_CLASS_HANDLE ClassHandle, bool GetAggregateFields,
                     std::list<CORINFO_CLASS_HANDLE> *DeferredDetailAggregates) {
   Type *Result = nullptr;
   if (DeferredDetailAggregates == nullptr) {
+    // This is the outermost request, so time it for the type translation
+    // statistics.
+    auto StartTime = std::chrono::steady_clock::now();
+
     // Keep track of any aggregates that we deferred examining in detail, so we
     // can come back to them when this aggregate is filled in.
     std::list<CORINFO_CLASS_HANDLE> TheDeferredDetailAggregates;
@@ -1769,6 +1863,10 @@ GenIR::getClassType(CORINFO_CLASS_HANDLE ClassHandle, bool GetAggregateFields,
                          DeferredDetailAggregates);
       ++It;
     }
+
+    std::chrono::duration<double> Elapsed =
+        std::chrono::steady_clock::now() - StartTime;
+    JitContext->TypeTranslation.Seconds += Elapsed.count();
   } else {
     if (!GetAggregateFields) {
       DeferredDetailAggregates->push_back(ClassHandle);
@@ -1872,6 +1970,11 @@ std::string GenIR::appendClassNameAsString(CORINFO_CLASS_HANDLE Class,
 // If GetAggregateFields is false, then we won't fill in the
 // field information for aggregates. This is used to avoid
 // getting trapped in cycles in the type reference graph.
+//
+// Classes that declare many fields (generated DTOs and the like) get a
+// compact layout: only the fields the GC and the struct size depend on are
+// typed, and everything else is padding. Accesses to the other fields are
+// addressed by offset, see simpleFieldAddress.
 Type *GenIR::getClassTypeWorker(
     CORINFO_CLASS_HANDLE ClassHandle, bool GetAggregateFields,
     std::list<CORINFO_CLASS_HANDLE> *DeferredDetailClasses) {
@@ -1901,7 +2004,7 @@ Type *GenIR::getClassTypeWorker(
     }
   }
 
-  bool IsRefClass = !JitContext->JitInfo->isValueClass(ClassHandle);
+  bool IsRefClass = !isValueClass(ClassHandle);
 
   if (ResultTy != nullptr) {
     // See if we can just return this result.
@@ -1979,7 +2082,8 @@ Type *GenIR::getClassTypeWorker(
   // Note getClassNumInstanceFields includes fields from
   // all ancestor classes. We'll need to subtract those out to figure
   // out how many fields this class uniquely contributes.
-  const uint32_t NumFields = getClassNumInstanceFields(ClassHandle);
+  const ClassFieldLayout &Layout = getClassFieldLayout(ClassHandle);
+  const uint32_t NumFields = Layout.NumInstanceFields;
   std::vector<Type *> Fields;
   uint32_t ByteOffset = 0;
   uint32_t NumParentFields = 0;
@@ -2087,7 +2191,8 @@ Type *GenIR::getClassTypeWorker(
         }
 
         // Set number of parent fields and cumulative offset into this object.
-        NumParentFields = getClassNumInstanceFields(ParentClassHandle);
+        NumParentFields =
+            getClassFieldLayout(ParentClassHandle).NumInstanceFields;
         ByteOffset = DataLayout->getTypeSizeInBits(ParentTy) / 8;
       } else {
         NumParentFields = 0;
@@ -2099,27 +2204,22 @@ Type *GenIR::getClassTypeWorker(
     ASSERT(NumFields >= NumParentFields);
     const uint32_t NumDerivedFields = NumFields - NumParentFields;
 
-    // Add the fields (if any) contributed by this class.
-    // We need to add them in increasing order of offset, but the EE
-    // gives them to us in somewhat arbitrary order. So we have to sort.
-    std::vector<std::pair<uint32_t, CORINFO_FIELD_HANDLE>> DerivedFields;
-
-    for (uint32_t I = 0; I < NumDerivedFields; I++) {
-      CORINFO_FIELD_HANDLE FieldHandle = getFieldInClass(ClassHandle, I);
-      if (FieldHandle == nullptr) {
-        // Likely a class that derives from System.__ComObject. See
-        // LLILC issue #557. We'll just have to cope with an incomplete
-        // picture of this type.
-        assert(IsRefClass && "need to see all fields of value classes");
-        break;
-      }
-      const uint32_t FieldOffset = getFieldOffset(FieldHandle);
-      DerivedFields.push_back(std::make_pair(FieldOffset, FieldHandle));
+    // Decide whether to give this class a compact layout. Types with special
+    // layouts or overlapping fields always get the full one. Value classes
+    // with this many fields are too big to be passed in registers, so the
+    // ABI classification of their fields doesn't matter either.
+    const uint32_t CompactClassFields = JitContext->Options->CompactClassFields;
+    const bool IsCompact = (CompactClassFields != 0) &&
+                           (NumDerivedFields > CompactClassFields) &&
+                           !IsString && !IsTypedByref && !IsUnion && !IsArray;
+    uint32_t CompactEndOffset = ByteOffset;
+    if (IsCompact) {
+      JitContext->TypeTranslation.CompactClasses++;
     }
 
-    // Putting offset first in the pair lets us use the
-    // default comparator here.
-    std::sort(DerivedFields.begin(), DerivedFields.end());
+    // Add the fields (if any) contributed by this class. The layout has
+    // them in increasing order of offset.
+    const std::vector<FieldLayoutEntry> &DerivedFields = Layout.Fields;
 
     // If we find overlapping fields, we'll stash them here so we can look
     // at them collectively.
@@ -2127,9 +2227,9 @@ Type *GenIR::getClassTypeWorker(
 
     // Now walk the fields in increasing offset order, adding
     // them and padding to the struct as we go.
-    for (const auto &FieldPair : DerivedFields) {
-      const uint32_t FieldOffset = FieldPair.first;
-      CORINFO_FIELD_HANDLE FieldHandle = FieldPair.second;
+    for (const FieldLayoutEntry &Field : DerivedFields) {
+      const uint32_t FieldOffset = Field.Offset;
+      CORINFO_FIELD_HANDLE FieldHandle = Field.Handle;
 
       // Prepare to add this field to the collection.
       //
@@ -2142,14 +2242,43 @@ Type *GenIR::getClassTypeWorker(
       //
       // We need to know the size of A before we can finish B. So we can't
       // ask for B's details while filling out A.
-      CORINFO_CLASS_HANDLE FieldClassHandle;
-      CorInfoType CorInfoType = getFieldType(FieldHandle, &FieldClassHandle);
-
-      const bool GetAggregateFields = ((CorInfoType != CORINFO_TYPE_CLASS) &&
-                                       (CorInfoType != CORINFO_TYPE_PTR) &&
-                                       (CorInfoType != CORINFO_TYPE_BYREF));
-      Type *FieldTy = getType(CorInfoType, FieldClassHandle, GetAggregateFields,
-                              DeferredDetailClasses);
+      CORINFO_CLASS_HANDLE FieldClassHandle = Field.Class;
+      CorInfoType CorInfoType = Field.Type;
+
+      Type *FieldTy = nullptr;
+      if (IsCompact) {
+        if ((CorInfoType == CORINFO_TYPE_CLASS) ||
+            (CorInfoType == CORINFO_TYPE_STRING)) {
+          // Any object reference will do for the GC. Leaving out the field's
+          // class keeps it (and the classes its fields refer to) from being
+          // built just because this class was.
+          FieldTy = getBuiltInObjectType();
+          JitContext->TypeTranslation.UntypedReferences++;
+        } else if ((CorInfoType != CORINFO_TYPE_VALUECLASS) &&
+                   (CorInfoType != CORINFO_TYPE_REFANY) &&
+                   (CorInfoType != CORINFO_TYPE_BYREF)) {
+          // Not a GC reference and not an aggregate that may hold one, so
+          // fold it into the padding before the next typed field. Unmanaged
+          // pointers are sized directly to avoid building their referent.
+          uint32_t FieldSize =
+              (CorInfoType == CORINFO_TYPE_PTR)
+                  ? getPointerByteSize()
+                  : DataLayout->getTypeSizeInBits(
+                        getType(CorInfoType, nullptr)) / 8;
+          CompactEndOffset =
+              std::max(CompactEndOffset, FieldOffset + FieldSize);
+          JitContext->TypeTranslation.CollapsedFields++;
+          continue;
+        }
+      }
+
+      if (FieldTy == nullptr) {
+        const bool GetAggregateFields = ((CorInfoType != CORINFO_TYPE_CLASS) &&
+                                         (CorInfoType != CORINFO_TYPE_PTR) &&
+                                         (CorInfoType != CORINFO_TYPE_BYREF));
+        FieldTy = getType(CorInfoType, FieldClassHandle, GetAggregateFields,
+                          DeferredDetailClasses);
+      }
       // Double check that if the field is of struct type, we got its field
       // details.
       assert(!FieldTy->isStructTy() || !cast<StructType>(FieldTy)->isOpaque());
@@ -2219,15 +2348,14 @@ Type *GenIR::getClassTypeWorker(
       // The first field of a typed byref is really GC (interior)
       // pointer. It's described in metadata as a pointer-sized integer.
       // Tweak it back...
-      if (IsTypedByref && (FieldHandle == DerivedFields[0].second)) {
+      if (IsTypedByref && (FieldHandle == DerivedFields.front().Handle)) {
         FieldTy = getManagedPointerType(FieldTy);
       }
 
       // The last field of a string is really the start of an array
       // of characters. In LLVM we use a zero-sized array to
       // describe this.
-      if (IsString &&
-          (FieldHandle == DerivedFields[NumDerivedFields - 1].second)) {
+      if (IsString && (FieldHandle == DerivedFields.back().Handle)) {
         FieldTy = ArrayType::get(FieldTy, 0);
       }
 
@@ -2243,6 +2371,16 @@ Type *GenIR::getClassTypeWorker(
       assert(OverlappingFields.empty());
     }
 
+    // Cover any fields a compact layout folded away after the last typed
+    // field, so that derived classes and the end padding below see the
+    // right size.
+    if (CompactEndOffset > ByteOffset) {
+      const uint32_t PadSize = CompactEndOffset - ByteOffset;
+      Type *PadTy = ArrayType::get(Type::getInt8Ty(LLVMContext), PadSize);
+      Fields.push_back(PadTy);
+      ByteOffset += DataLayout->getTypeSizeInBits(PadTy) / 8;
+    }
+
     // If this is a value class, account for any additional end
     // padding that the runtime sees fit to add.
     //
@@ -2459,7 +2597,7 @@ char *GenIR::getClassNameWithNamespace(CORINFO_CLASS_HANDLE ClassHandle) {
 }
 
 Type *GenIR::getBoxedType(CORINFO_CLASS_HANDLE Class) {
-  assert(JitContext->JitInfo->isValueClass(Class));
+  assert(isValueClass(Class));
 
   // Check to see if the boxed version of this type has already been generated.
   auto MapElement = BoxedTypeMap->find(Class);
@@ -3455,7 +3593,22 @@ Instruction *GenIR::createEHPad(EHRegion *Handler, Instruction *&EndPad,
   return Pad;
 }
 
-void GenIR::endFlowGraphNode(FlowGraphNode *Fg, uint32_t CurrOffset) { return; }
+void GenIR::endFlowGraphNode(FlowGraphNode *Fg, uint32_t CurrOffset) {
+  // Keep a running estimate of the IR built so far, so that pathological
+  // methods are abandoned before the reader has built all of their IR. The
+  // reader may have split the node, so count the block it ended in too.
+  // Each block is counted once; the estimate is recomputed from the whole
+  // module when the reader is done.
+  for (BasicBlock *Block : {(BasicBlock *)Fg, LLVMBuilder->GetInsertBlock()}) {
+    if ((Block != nullptr) && EstimatedBlocks.insert(Block).second) {
+      JitContext->IRMemory += LLILCJitContext::estimateIRMemory(*Block);
+    }
+  }
+
+  if (JitContext->isOverBudget("reader")) {
+    throw CompileBudgetExceededException();
+  }
+}
 
 IRNode *GenIR::findBlockSplitPointAfterNode(IRNode *Node) {
   if (Node == nullptr) {
@@ -3724,9 +3877,13 @@ IRNode *GenIR::loadLen(IRNode *Array, bool ArrayMayBeNull) {
   // Length field is at index 1. Get its address.
   Value *LengthFieldAddress = LLVMBuilder->CreateStructGEP(nullptr, Array, 1);
 
-  // Load and return the length.
-  // TODO: this load cannot be aliased.
-  Value *Length = makeLoad(LengthFieldAddress, false, ArrayMayBeNull);
+  // Load and return the length. An array's length never changes, so mark the
+  // load invariant; this lets it be hoisted out of loops along with the
+  // bounds checks that compare against it.
+  LoadInst *Length = makeLoad(LengthFieldAddress, false, ArrayMayBeNull);
+  MDNode *EmptyNode =
+      MDNode::get(*JitContext->LLVMContext, ArrayRef<Metadata *>());
+  Length->setMetadata(LLVMContext::MD_invariant_load, EmptyNode);
 
   // Result is an unsigned native int.
   IRNode *Result = convertToStackType((IRNode *)Length,
@@ -4738,7 +4895,7 @@ void GenIR::storeIndirectArg(const CallArgType &ValueArgType,
 
   const ReaderAlignType Alignment =
       getMinimumClassAlignment(ArgClass, Reader_AlignNatural);
-  const bool IsNotValueClass = !JitContext->JitInfo->isValueClass(ArgClass);
+  const bool IsNotValueClass = !isValueClass(ArgClass);
   const bool IsValueIsPointer = true;
   const bool IsFieldToken = false;
   const bool IsUnchecked = false;
@@ -4885,7 +5042,12 @@ IRNode *GenIR::loadStaticField(CORINFO_RESOLVED_TOKEN *FieldToken,
   CorInfoType FieldCorType = getFieldType(FieldHandle, &FieldClassHandle);
   Type *FieldTy = getType(FieldCorType, FieldClassHandle);
 
-  // TODO: Replace static read-only fields with constant when possible
+  // Replace static read-only fields with constant when possible
+  IRNode *FoldedValue = loadReadOnlyStaticFieldConstant(
+      FieldToken, &FieldInfo, FieldTy, FieldCorType);
+  if (FoldedValue != nullptr) {
+    return FoldedValue;
+  }
 
   // Get static field address. Convert to pointer.
   Value *Address = rdrGetStaticFieldAddress(FieldToken, &FieldInfo);
@@ -4901,6 +5063,66 @@ IRNode *GenIR::loadStaticField(CORINFO_RESOLVED_TOKEN *FieldToken,
                               Reader_AlignNatural, IsVolatile);
 }
 
+IRNode *
+GenIR::loadReadOnlyStaticFieldConstant(CORINFO_RESOLVED_TOKEN *FieldToken,
+                                       CORINFO_FIELD_INFO *FieldInfo,
+                                       Type *FieldTy, CorInfoType FieldCorType) {
+  if ((FieldInfo->fieldFlags & CORINFO_FLG_FIELD_FINAL) == 0) {
+    return nullptr;
+  }
+
+  // Keep the field observable when debugging, and don't bake values into
+  // code that may run in a different process.
+  const uint32_t JitFlags = JitContext->Flags;
+  if ((JitFlags & (CORJIT_FLG_DEBUG_CODE | CORJIT_FLG_READYTORUN)) != 0) {
+    return nullptr;
+  }
+
+  // Only fields with a fixed address; RVA statics are mutable through
+  // pointers and boxed value class statics are not primitive.
+  if ((FieldInfo->fieldAccessor != CORINFO_FIELD_STATIC_ADDRESS) ||
+      ((FieldInfo->fieldFlags & CORINFO_FLG_FIELD_STATIC_IN_HEAP) != 0)) {
+    return nullptr;
+  }
+
+  // GC references can't be embedded since the referent may move.
+  if (!FieldTy->isIntegerTy() && !FieldTy->isFloatingPointTy()) {
+    return nullptr;
+  }
+
+  // The value is final only once the class constructor has completed.
+  CORINFO_FIELD_HANDLE FieldHandle = FieldToken->hField;
+  const bool Speculative = true;
+  CorInfoInitClassResult InitResult = initClass(
+      FieldHandle, getCurrentMethodHandle(), getCurrentContext(), Speculative);
+  if ((InitResult & CORINFO_INITCLASS_INITIALIZED) == 0) {
+    return nullptr;
+  }
+
+  bool IsIndirect;
+  void *FieldAddress = getStaticFieldAddress(FieldHandle, &IsIndirect);
+  if (IsIndirect || (FieldAddress == nullptr)) {
+    return nullptr;
+  }
+
+  // Still perform the access check the load would have done.
+  handleMemberAccess(FieldInfo->accessAllowed, FieldInfo->accessCalloutHelper);
+
+  Constant *FieldValue;
+  uint32_t SizeInBits = FieldTy->getPrimitiveSizeInBits();
+  uint64_t Bits = 0;
+  memcpy(&Bits, FieldAddress, SizeInBits / 8);
+  APInt BitValue(SizeInBits, Bits);
+  if (FieldTy->isIntegerTy()) {
+    FieldValue = ConstantInt::get(*JitContext->LLVMContext, BitValue);
+  } else {
+    FieldValue = ConstantFP::get(*JitContext->LLVMContext,
+                                 APFloat(FieldTy->getFltSemantics(), BitValue));
+  }
+
+  return convertToStackType((IRNode *)FieldValue, FieldCorType);
+}
+
 IRNode *GenIR::addressOfValue(IRNode *Leaf) {
   Type *LeafTy = Leaf->getType();
 
@@ -4978,7 +5200,7 @@ IRNode *GenIR::loadElemA(CORINFO_RESOLVED_TOKEN *ResolvedToken, IRNode *Index,
   ASSERTNR(ResolvedToken != nullptr);
   CORINFO_CLASS_HANDLE ClassHandle = ResolvedToken->hClass;
   uint32_t ClassAttribs = getClassAttribs(ClassHandle);
-  CorInfoType CorInfoType = JitContext->JitInfo->asCorInfoType(ClassHandle);
+  CorInfoType CorInfoType = ReaderBase::getClassType(ClassHandle);
   Type *ElementTy = getType(CorInfoType, ClassHandle);
 
   // Attempt to use a helper call.
@@ -5079,7 +5301,7 @@ Type *GenIR::getMSILArrayElementType(IRNode *Array,
 
   if (ResolvedToken != nullptr) {
     ClassHandle = ResolvedToken->hClass;
-    *CorType = JitContext->JitInfo->asCorInfoType(ClassHandle);
+    *CorType = ReaderBase::getClassType(ClassHandle);
     if ((*CorType == CorInfoType::CORINFO_TYPE_VALUECLASS) ||
         (*CorType == CORINFO_TYPE_REFANY)) {
       *Alignment = getMinimumClassAlignment(ClassHandle, Reader_AlignNatural);
@@ -5505,10 +5727,21 @@ IRNode *GenIR::callHelper(CorInfoHelpFunc HelperID, bool MayThrow, IRNode *Dst,
   LLVMContext &LLVMContext = *this->JitContext->LLVMContext;
   Type *ReturnType =
       (Dst == nullptr) ? Type::getVoidTy(LLVMContext) : Dst->getType();
-  return (IRNode *)callHelperImpl(HelperID, MayThrow, ReturnType, Arg1, Arg2,
-                                  Arg3, Arg4, Alignment, IsVolatile, NoCtor,
-                                  CanMoveUp)
-      .getInstruction();
+  CallSite Call = callHelperImpl(HelperID, MayThrow, ReturnType, Arg1, Arg2,
+                                 Arg3, Arg4, Alignment, IsVolatile, NoCtor,
+                                 CanMoveUp);
+
+  if ((HelperID == CORINFO_HELP_GETSHARED_GCTHREADSTATIC_BASE_NOCTOR) ||
+      (HelperID == CORINFO_HELP_GETSHARED_NONGCTHREADSTATIC_BASE_NOCTOR)) {
+    // These helpers never run a class constructor, and on a given thread they
+    // return the same base for the same class. Marking the call readnone lets
+    // EarlyCSE and GVN reuse one call for repeated accesses, and lets LICM
+    // hoist it out of a loop when the loop always reaches it. The call stays
+    // where the access is, so it only runs on paths that make the access.
+    Call.setDoesNotAccessMemory();
+  }
+
+  return (IRNode *)Call.getInstruction();
 }
 
 IRNode *GenIR::callHelper(CorInfoHelpFunc HelperID, IRNode *HelperAddress,
@@ -5721,7 +5954,7 @@ IRNode *GenIR::callRuntimeHandleHelper(CorInfoHelpFunc Helper, IRNode *Arg1,
 IRNode *GenIR::convertHandle(IRNode *GetTokenNumericNode,
                              CorInfoHelpFunc HelperID,
                              CORINFO_CLASS_HANDLE ClassHandle) {
-  CorInfoType CorType = JitContext->JitInfo->asCorInfoType(ClassHandle);
+  CorInfoType CorType = ReaderBase::getClassType(ClassHandle);
   Type *ResultType = getType(CorType, ClassHandle);
 
   // We expect RuntimeTypeHandle, or RuntimeMethodHandle, or RuntimeFieldHandle,
@@ -5831,8 +6064,7 @@ IRNode *GenIR::makeDirectCallTargetNode(CORINFO_METHOD_HANDLE MethodHandle,
       Type::getIntNTy(*JitContext->LLVMContext, TargetPointerSizeInBits);
   const bool IsConstant = true;
   const char *ModuleName = nullptr;
-  const char *MethodName =
-      JitContext->JitInfo->getMethodName(MethodHandle, &ModuleName);
+  const char *MethodName = getMethodName(MethodHandle, &ModuleName);
 
   std::string FullName;
   raw_string_ostream OS(FullName);
@@ -5846,6 +6078,34 @@ IRNode *GenIR::makeDirectCallTargetNode(CORINFO_METHOD_HANDLE MethodHandle,
   return (IRNode *)CodeAddrValue;
 }
 
+void GenIR::recordDelegateTarget(IRNode *Delegate, CORINFO_METHOD_HANDLE Method,
+                                 mdToken MethodToken, IRNode *TargetObject) {
+  DelegateTargetInfo &Target = KnownDelegateTargets[Delegate];
+  Target.Method = Method;
+  Target.MethodToken = MethodToken;
+  Target.TargetObject = TargetObject;
+}
+
+bool GenIR::getDelegateTarget(IRNode *Delegate, CORINFO_METHOD_HANDLE *Method,
+                              mdToken *MethodToken, IRNode **TargetObject) {
+  auto Known = KnownDelegateTargets.find(Delegate);
+  if (Known == KnownDelegateTargets.end()) {
+    return false;
+  }
+
+  // The bound instance may have been deleted since the delegate was made.
+  const DelegateTargetInfo &Target = Known->second;
+  Value *TargetObjectValue = Target.TargetObject;
+  if (TargetObjectValue == nullptr) {
+    return false;
+  }
+
+  *Method = Target.Method;
+  *MethodToken = Target.MethodToken;
+  *TargetObject = (IRNode *)TargetObjectValue;
+  return true;
+}
+
 // Helper callback used by rdrCall to emit a call to allocate a new MDArray.
 IRNode *GenIR::genNewMDArrayCall(ReaderCallTargetData *CallTargetData,
                                  std::vector<IRNode *> Args,
@@ -6305,28 +6565,24 @@ Value *GenIR::genConvertOverflowCheck(Value *Source, IntegerType *TargetTy,
         // Signed -> Signed narrowing conversion overflows iff
         //   (source is less than sext(signedMinValue(TargetBitWidth)) or
         //    source is greater than ext(signedMaxValue(TargetBitWidth)))
-        // Use two comparisons (rather than a subtract and single compare) to
-        // make the IR more straightforward for downstream analysis (range
-        // propagation won't have to rewind through the subtract).  With throw
-        // block sharing, subsequent optimization should be able to rewrite
-        // the two-compare sequence to subtract-compare.
-
-        APInt MinSmallInt =
-            APInt::getSignedMinValue(TargetBitWidth).sext(SourceBitWidth);
-        ConstantInt *MinConstant =
-            ConstantInt::get(*JitContext->LLVMContext, MinSmallInt);
-        Value *TooSmall =
-            LLVMBuilder->CreateICmpSLT(Source, MinConstant, "Ovf");
-
-        genConditionalThrow(TooSmall, CORINFO_HELP_OVERFLOW, "ThrowOverflow");
-
-        APInt MaxSmallInt =
-            APInt::getSignedMaxValue(TargetBitWidth).sext(SourceBitWidth);
+        // Fold the two range checks into a single unsigned compare by biasing
+        // the source so the valid range starts at zero:
+        //   (source + 2^(TargetBitWidth-1)) >u unsignedMaxValue(TargetBitWidth)
+        // This costs one add, one compare and one branch to the (shared)
+        // overflow throw block.
+
+        APInt BiasInt = APInt::getOneBitSet(SourceBitWidth, TargetBitWidth - 1);
+        ConstantInt *BiasConstant =
+            ConstantInt::get(*JitContext->LLVMContext, BiasInt);
+        Value *Biased = LLVMBuilder->CreateAdd(Source, BiasConstant);
+
+        APInt MaxBiasedInt =
+            APInt::getMaxValue(TargetBitWidth).zext(SourceBitWidth);
         ConstantInt *MaxConstant =
-            ConstantInt::get(*JitContext->LLVMContext, MaxSmallInt);
-        Value *TooBig = LLVMBuilder->CreateICmpSGT(Source, MaxConstant, "Ovf");
+            ConstantInt::get(*JitContext->LLVMContext, MaxBiasedInt);
+        Value *Ovf = LLVMBuilder->CreateICmpUGT(Biased, MaxConstant, "Ovf");
 
-        genConditionalThrow(TooBig, CORINFO_HELP_OVERFLOW, "ThrowOverflow");
+        genConditionalThrow(Ovf, CORINFO_HELP_OVERFLOW, "ThrowOverflow");
       } else {
         // Unsigned -> Signed narrowing conversion overflows iff source is
         // unsigned-greater-than zext(signedMaxValue(TargetBitWidth))
@@ -6960,12 +7216,35 @@ CallSite GenIR::genConditionalHelperCall(
 // Generate a call to the throw helper if the condition is met.
 void GenIR::genConditionalThrow(Value *Condition, CorInfoHelpFunc HelperId,
                                 const Twine &ThrowBlockName) {
+  // Throw blocks take no arguments and never return, so any two conditional
+  // throws of the same exception that unwind to the same handler can share
+  // one.  Don't share while the flow graph is still being built (point blocks
+  // are then tied to their MSIL offset), nor in debug code, where each throw
+  // should keep its own IL offset.
+  const bool CanShare = DoneBuildingFlowGraph &&
+                        ((JitContext->Flags & CORJIT_FLG_DEBUG_CODE) == 0);
+  std::pair<CorInfoHelpFunc, EHRegion *> Key(HelperId, CurrentRegion);
+
+  if (CanShare) {
+    auto Found = ThrowBlockMap.find(Key);
+    if (Found != ThrowBlockMap.end()) {
+      const bool Rejoin = false;
+      insertConditionalPointBlock(Condition, Found->second, Rejoin);
+      return;
+    }
+  }
+
   IRNode *Arg1 = nullptr, *Arg2 = nullptr;
   Type *ReturnType = Type::getVoidTy(*JitContext->LLVMContext);
   const bool MayThrow = true;
   const bool CallReturns = false;
-  genConditionalHelperCall(Condition, HelperId, MayThrow, ReturnType, Arg1,
-                           Arg2, CallReturns, ThrowBlockName);
+  CallSite ThrowCall =
+      genConditionalHelperCall(Condition, HelperId, MayThrow, ReturnType, Arg1,
+                               Arg2, CallReturns, ThrowBlockName);
+
+  if (CanShare) {
+    ThrowBlockMap[Key] = ThrowCall.getInstruction()->getParent();
+  }
 }
 
 IRNode *GenIR::genNullCheck(IRNode *Node) {
@@ -6983,16 +7262,29 @@ void GenIR::genBoundsCheck(Value *ArrayLength, Value *Index) {
   CorInfoHelpFunc HelperId = CORINFO_HELP_RNGCHKFAIL;
 
   // Insert the bound compare.
-  // The unsigned conversion allows us to also catch negative indices in the
-  // compare.
+  // The unsigned compare allows us to also catch negative indices.
   Type *ArrayLengthType = ArrayLength->getType();
-  ASSERTNR(Index->getType()->getPrimitiveSizeInBits() <=
+  Type *IndexType = Index->getType();
+  ASSERTNR(IndexType->getPrimitiveSizeInBits() <=
            ArrayLengthType->getPrimitiveSizeInBits());
-  bool IsSigned = false;
-  Value *ConvertedIndex =
-      LLVMBuilder->CreateIntCast(Index, ArrayLengthType, IsSigned);
-  Value *UpperBoundCompare =
-      LLVMBuilder->CreateICmpUGE(ConvertedIndex, ArrayLength, "BoundsCheck");
+
+  // Lengths always fit in 32 bits, so an unsigned compare of a narrower index
+  // against the truncated length is equivalent to widening the index. Doing
+  // the compare at the index's width keeps the index a simple induction
+  // variable in loops, which range check elimination relies on.
+  Value *UpperBoundCompare;
+  if (IndexType->getPrimitiveSizeInBits() >= 32) {
+    Value *TruncatedLength =
+        LLVMBuilder->CreateTrunc(ArrayLength, IndexType, "Length");
+    UpperBoundCompare =
+        LLVMBuilder->CreateICmpUGE(Index, TruncatedLength, "BoundsCheck");
+  } else {
+    bool IsSigned = false;
+    Value *ConvertedIndex =
+        LLVMBuilder->CreateIntCast(Index, ArrayLengthType, IsSigned);
+    UpperBoundCompare =
+        LLVMBuilder->CreateICmpUGE(ConvertedIndex, ArrayLength, "BoundsCheck");
+  }
   genConditionalThrow(UpperBoundCompare, HelperId, "ThrowIndexOutOfRange");
 }
 
@@ -7386,8 +7678,7 @@ std::string GenIR::getNameForToken(mdToken Token, CORINFO_GENERIC_HANDLE Handle,
   case mdtMethodHandle: {
     const char *MethodName;
     const char *ModuleName = NULL;
-    MethodName = JitContext->JitInfo->getMethodName(
-        (CORINFO_METHOD_HANDLE)Handle, &ModuleName);
+    MethodName = getMethodName((CORINFO_METHOD_HANDLE)Handle, &ModuleName);
     OS << format("TypeContext(%s.%s)", ModuleName, MethodName);
   } break;
   case mdtClassHandle: {
@@ -7812,7 +8103,7 @@ IRNode *GenIR::loadNonPrimitiveObj(IRNode *Addr,
                                    ReaderAlignType Alignment, bool IsVolatile,
                                    bool AddressMayBeNull) {
   uint32_t Align;
-  CorInfoType CorType = JitContext->JitInfo->asCorInfoType(ClassHandle);
+  CorInfoType CorType = ReaderBase::getClassType(ClassHandle);
   IRNode *TypedAddr =
       getTypedAddress(Addr, CorType, ClassHandle, Alignment, &Align);
   Type *Type = getType(CorType, ClassHandle);
@@ -8156,7 +8447,7 @@ IRNode *GenIR::castOp(CORINFO_RESOLVED_TOKEN *ResolvedToken, IRNode *ObjRefNode,
                       CorInfoHelpFunc HelperId) {
   CORINFO_CLASS_HANDLE Class = ResolvedToken->hClass;
   Type *ResultType = nullptr;
-  if (JitContext->JitInfo->isValueClass(Class)) {
+  if (isValueClass(Class)) {
     ResultType = getBoxedType(Class);
   } else {
     ResultType = getType(CORINFO_TYPE_CLASS, Class);
@@ -8271,8 +8562,27 @@ IRNode *GenIR::localAlloc(IRNode *Arg, bool ZeroInit) {
   const unsigned int Alignment = TargetPointerSizeInBits / 8;
   LLVMContext &Context = *JitContext->LLVMContext;
   Type *Ty = Type::getInt8Ty(Context);
-  AllocaInst *LocAlloc = createAlloca(Ty, Arg, "LocAlloc");
-  LocAlloc->setAlignment(Alignment);
+  Value *LocAlloc;
+
+  // A small constant-size localloc that executes at most once per call can
+  // live in a fixed frame slot: this keeps the frame static (no frame pointer
+  // or stack probes needed for it) and lets the slot be optimized like any
+  // other local. With a loop, each execution must yield distinct memory.
+  ConstantInt *ConstantSize = dyn_cast<ConstantInt>(Arg);
+  if ((ConstantSize != nullptr) && !HasBackwardBranch &&
+      !ConstantSize->isZero() &&
+      ConstantSize->getValue().ule(MaxFixedLocAllocSize)) {
+    Type *BufferTy = ArrayType::get(Ty, ConstantSize->getZExtValue());
+    AllocaInst *Buffer =
+        cast<AllocaInst>(createTemporary(BufferTy, "LocAlloc"));
+    Buffer->setAlignment(Alignment);
+    LocAlloc =
+        LLVMBuilder->CreatePointerCast(Buffer, getUnmanagedPointerType(Ty));
+  } else {
+    AllocaInst *DynamicAlloc = createAlloca(Ty, Arg, "LocAlloc");
+    DynamicAlloc->setAlignment(Alignment);
+    LocAlloc = DynamicAlloc;
+  }
 
   // Zero the allocated region if so requested.
   if (ZeroInit) {
@@ -8629,7 +8939,7 @@ Type *GenIR::getStackMergeType(Type *Ty1, Type *Ty2, bool IsStruct1,
     CORINFO_CLASS_HANDLE MergedClass = nullptr;
     if ((Class1 != nullptr) && (Class2 != nullptr)) {
       MergedClass = JitContext->JitInfo->mergeClasses(Class1, Class2);
-      ASSERT(!JitContext->JitInfo->isValueClass(MergedClass));
+      ASSERT(!isValueClass(MergedClass));
     } else {
       // We can get here if one of the types is an array or a boxed type.
       // We can't map arrays back to its handles because an array can be
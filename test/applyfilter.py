@@ -71,11 +71,14 @@ def ApplyOne(src, dest, summary=None):
     else:
         re_read_failure = re.compile(r'Failed to read ')
         re_read_success = re.compile(r'Successfully read ')
+        re_code_range = re.compile(r'LLILC compiled: ')
         with open(src, 'r') as ins, open(dest, 'w') as outs, open(summary, 'w') as sums:
             for line in ins:
                 extract = re_read_failure.search(line)
                 if extract is None:
                     extract = re_read_success.search(line)
+                if extract is None:
+                    extract = re_code_range.search(line)
                 if extract is not None:
                     sums.write(line)
                 else:
@@ -17,9 +17,22 @@
 # methods that were only submitted to the base compiler and the number of
 # methods that were only submitted to the target compiler are reported on
 # stdout.
+#
+# If the results were produced with llilc_runtest --metrics, the per-method
+# compile time and native code size reported by the code range dump are also
+# collected. They can be written out as JSON, and when a base result is given,
+# methods whose median code size or compile time grew by more than the given
+# percentage are reported as performance regressions. Compile time is noisy,
+# so a compile time regression additionally requires enough samples and an
+# increase larger than twice the median absolute deviation of the samples.
+# Performance regressions only affect the return code if --fail-on-perf is
+# given.
 # 
 # usage: llilc_checkpass.py [-h] -d DIFF_RESULT_PATH [-b BASE_RESULT_PATH] [-v]
-#                           [--bs] [--ts]
+#                           [--bs] [--ts] [--metrics-json METRICS_JSON]
+#                           [--size-threshold SIZE_THRESHOLD]
+#                           [--time-threshold TIME_THRESHOLD]
+#                           [--min-samples MIN_SAMPLES] [--fail-on-perf]
 # 
 # Check the output of a LLILC test run (optionally against a prior baseline
 # run), for each test looking to see which methods LLILC reported as passing or
@@ -38,6 +51,19 @@
 #                         Show target failure summary.  This has all target
 #                         failures, even those that failed in the baseline (if
 #                         any).
+#   --metrics-json METRICS_JSON
+#                         write per-method and per-test compile metrics, and
+#                         any performance regressions, to this JSON file
+#   --size-threshold SIZE_THRESHOLD
+#                         percentage growth in native code size reported as a
+#                         regression (default: 5)
+#   --time-threshold TIME_THRESHOLD
+#                         percentage growth in compile time reported as a
+#                         regression (default: 20)
+#   --min-samples MIN_SAMPLES
+#                         minimum number of compile time samples per method in
+#                         both results before comparing (default: 3)
+#   --fail-on-perf        count performance regressions as unexpected failures
 # 
 # required arguments:
 #   -d DIFF_RESULT_PATH, --diff-result-path DIFF_RESULT_PATH
@@ -46,6 +72,8 @@
 #==========================================================================================
 
 import argparse
+import json
+import math
 import re
 import sys
 import os
@@ -89,6 +117,119 @@ def analyze(file_path, pattern_reg_exp):
                     fail_reason_map[method] = reason
     return passing, failing, fail_reason_map
 
+def analyze_metrics(file_path, metrics_reg_exp, method_metrics):
+    """ Record the code size and compile time samples in file_path.
+
+        method_metrics maps a method to a dict with 'size' and 'time' sample
+        lists; samples from this file are appended to it. Returns the total
+        code size and compile time (in microseconds) reported by the file.
+    """
+    #
+    # For reference, here is the metrics regular expression:
+    #
+    # r'^LLILC compiled: .*, size = (\d+)(, time = (\d+) us)? method = (.*)$'
+    #
+    total_size, total_time = 0, 0
+    with open(file_path, 'r') as file:
+        for line in file:
+            m = metrics_reg_exp.match(line)
+            if m:
+                method = m.group(4)
+                if not method in method_metrics:
+                    method_metrics[method] = {'size': [], 'time': []}
+                metrics = method_metrics[method]
+                size = int(m.group(1))
+                metrics['size'].append(size)
+                total_size += size
+                if m.group(3):
+                    time = int(m.group(3))
+                    metrics['time'].append(time)
+                    total_time += time
+    return total_size, total_time
+
+def median(values):
+    """ Median of a non-empty list of numbers. """
+    ordered = sorted(values)
+    mid = len(ordered) // 2
+    if len(ordered) % 2 == 1:
+        return ordered[mid]
+    return (ordered[mid - 1] + ordered[mid]) / 2.0
+
+def median_absolute_deviation(values):
+    """ Median absolute deviation of a non-empty list of numbers. """
+    center = median(values)
+    return median([abs(value - center) for value in values])
+
+def percent_change(base, target):
+    return (target - base) * 100.0 / base
+
+def summarize_metrics(method_metrics):
+    """ Reduce per-method samples to medians for reporting. """
+    summary = {}
+    for method in method_metrics:
+        metrics = method_metrics[method]
+        entry = {'size': median(metrics['size']), 'samples': len(metrics['size'])}
+        if metrics['time']:
+            entry['time_us'] = median(metrics['time'])
+        summary[method] = entry
+    return summary
+
+def compare_metrics(base_metrics, target_metrics, size_threshold, time_threshold,
+                    min_samples):
+    """ Compare per-method metrics of methods present in both results.
+
+        Returns the lists of code size and compile time regressions, each a
+        list of (method, base median, target median, percent change), and the
+        geometric mean ratios (target/base) of code size and compile time.
+    """
+    size_regressions, time_regressions = [], []
+    size_log_sum, size_count = 0.0, 0
+    time_log_sum, time_count = 0.0, 0
+    for method in target_metrics:
+        if not method in base_metrics:
+            continue
+        base = base_metrics[method]
+        target = target_metrics[method]
+
+        base_size = median(base['size'])
+        target_size = median(target['size'])
+        if base_size > 0 and target_size > 0:
+            size_log_sum += math.log(float(target_size) / base_size)
+            size_count += 1
+            change = percent_change(base_size, target_size)
+            if change > size_threshold:
+                size_regressions.append((method, base_size, target_size, change))
+
+        base_times = base['time']
+        target_times = target['time']
+        if len(base_times) < min_samples or len(target_times) < min_samples:
+            continue
+        base_time = median(base_times)
+        target_time = median(target_times)
+        if base_time <= 0 or target_time <= 0:
+            continue
+        time_log_sum += math.log(float(target_time) / base_time)
+        time_count += 1
+        change = percent_change(base_time, target_time)
+        noise = max(median_absolute_deviation(base_times),
+                    median_absolute_deviation(target_times))
+        if change > time_threshold and target_time - base_time > 2 * noise:
+            time_regressions.append((method, base_time, target_time, change))
+
+    size_regressions.sort(key=lambda regression: -regression[3])
+    time_regressions.sort(key=lambda regression: -regression[3])
+    size_ratio = math.exp(size_log_sum / size_count) if size_count else None
+    time_ratio = math.exp(time_log_sum / time_count) if time_count else None
+    return size_regressions, time_regressions, size_ratio, time_ratio
+
+def print_regressions(regressions, caption, unit):
+    """Print performance regressions, worst first"""
+    if regressions:
+        print('   ' + caption)
+        for method, base, target, change in regressions:
+            print(('        {method}: {base}{unit} -> {target}{unit} (+{change:.1f}%)').format(
+                  method=method, base=base, target=target, unit=unit, change=change))
+
 def get_fail_reason_diff(target_fail_reason_map, base_fail_reason_map):
     """Compute fail reason map for target, but not including failures from base"""
     diff_fail_reason_map = {}
@@ -257,6 +398,18 @@ def main(argv):
     parser.add_argument('--ts', '--target-summary', default=False, action="store_true",
                         help='''Show target failure summary. This has all target failures,
                         even those that failed in the baseline (if any).''')
+    parser.add_argument('--metrics-json', type=str,
+                        help='''write per-method and per-test compile metrics, and any
+                        performance regressions, to this JSON file''')
+    parser.add_argument('--size-threshold', type=float, default=5.0,
+                        help='percentage growth in native code size reported as a regression')
+    parser.add_argument('--time-threshold', type=float, default=20.0,
+                        help='percentage growth in compile time reported as a regression')
+    parser.add_argument('--min-samples', type=int, default=3,
+                        help='''minimum number of compile time samples per method in both
+                        results before comparing''')
+    parser.add_argument('--fail-on-perf', default=False, action="store_true",
+                        help='count performance regressions as unexpected failures')
 
     args, unknown = parser.parse_known_args(argv)
 
@@ -373,6 +526,18 @@ def main(argv):
     # All other lines are ignored.
     pattern_reg_exp = re.compile(r'^(Successfully read (.*))|(Failed to read (.*)\[(.*)\])$')
 
+    # With llilc_runtest --metrics the input also contains the code range dump,
+    # "LLILC compiled: , Entry = ..., size = <bytes>, time = <us> us method = <method>",
+    # from which code size and compile time are collected.
+    metrics_reg_exp = re.compile(r'^LLILC compiled: .*, size = (\d+)(, time = (\d+) us)? method = (.*)$')
+
+    # method -> {'size': [samples], 'time': [samples]}
+    base_method_metrics = {}
+    target_method_metrics = {}
+
+    # test -> {'code_size': total, 'compile_time_us': total}
+    target_test_metrics = {}
+
     print('Checking started.')
     all_files = {}
     for file in base_files:
@@ -399,12 +564,17 @@ def main(argv):
             target_file_path = os.path.join(args.diff_result_path, file)
             target_passing_methods, target_failing_methods, target_fail_reason_map = \
                 analyze(target_file_path, pattern_reg_exp)
+            test_size, test_time = analyze_metrics(target_file_path, metrics_reg_exp,
+                                                   target_method_metrics)
+            target_test_metrics[test] = {'code_size': test_size,
+                                         'compile_time_us': test_time}
 
             if in_which == 3:
                 # file processed by both old and new.
                 base_file_path = os.path.join(args.base_result_path, file)
                 base_passing_methods, base_failing_methods, base_fail_reason_map = \
                     analyze(base_file_path, pattern_reg_exp)
+                analyze_metrics(base_file_path, metrics_reg_exp, base_method_metrics)
             else:
                 # in_which must be 2. No base file, new result file.
                 if have_base:
@@ -559,6 +729,46 @@ def main(argv):
     if have_base:
         report(unexpected_failures, '{0} total failing methods excluding old fails')
 
+    size_regressions, time_regressions = [], []
+    if have_base and base_method_metrics and target_method_metrics:
+        size_regressions, time_regressions, size_ratio, time_ratio = \
+            compare_metrics(base_method_metrics, target_method_metrics,
+                            args.size_threshold, args.time_threshold,
+                            args.min_samples)
+        if verbose:
+            print_regressions(size_regressions, ' code size regressions', ' bytes')
+            print_regressions(time_regressions, ' compile time regressions', ' us')
+        if size_ratio is not None:
+            report(size_ratio, '{0:.4f} geometric mean code size ratio (target/base)')
+        if time_ratio is not None:
+            report(time_ratio, '{0:.4f} geometric mean compile time ratio (target/base)')
+        report(len(size_regressions), '{0} methods regressed code size by more than ' +
+               str(args.size_threshold) + '%')
+        report(len(time_regressions), '{0} methods regressed compile time by more than ' +
+               str(args.time_threshold) + '%')
+        if args.fail_on_perf:
+            unexpected_failures += len(size_regressions) + len(time_regressions)
+
+    if args.metrics_json:
+        metrics = {'methods': summarize_metrics(target_method_metrics),
+                   'tests': target_test_metrics}
+        if have_base:
+            metrics['base_methods'] = summarize_metrics(base_method_metrics)
+            metrics['size_regressions'] = [
+                {'method': method, 'base': base, 'target': target, 'percent': change}
+                for method, base, target, change in size_regressions]
+            metrics['time_regressions'] = [
+                {'method': method, 'base_us': base, 'target_us': target, 'percent': change}
+                for method, base, target, change in time_regressions]
+        try:
+            with open(args.metrics_json, 'w') as metrics_file:
+                json.dump(metrics, metrics_file, indent=2, sort_keys=True)
+        except:
+            e = sys.exc_info()[0]
+            print('Error: CheckPass failed to write metrics due to ', e)
+            traceback.print_exc()
+            return const.GeneralError
+
     if unexpected_failures == 0:
         print('There were no unexpected failures.')
     else:
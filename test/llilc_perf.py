@@ -0,0 +1,231 @@
+#!/usr/bin/env python
+#
+#title           :llilc_perf.py
+#description     :
+#
+# This script runs the CoreCLR code quality benchmarks
+# (JIT\Performance\CodeQuality) with LLILC as the alternate JIT and with the
+# default JIT (RyuJIT), and reports the time per run of each benchmark under
+# both, so that code generation changes in LLILC can be judged against
+# numbers rather than pass/fail.
+#
+# The benchmarks cover loops over arrays (BenchI, BenchF), field access and
+# calls in object-oriented code (Richards, DeltaBlue, Roslyn), allocation
+# (Burgers, BinaryTrees), strings (Serialization), Vector<T> (SIMD) and more;
+# use --filter to pick a subset. Each benchmark is run as its own process, so
+# the time includes jitting the benchmark; both JITs jit everything (ngen
+# images are disabled) and run under the same GC mode.
+#
+# It is required to run this script from tests directory in a CoreCLR
+# repository, after the tests have been built.
+#
+# usage: llilc_perf.py [-h] [-a {x64,x86}] [-b {debug,release}]
+#                      [-t RUNTEST_PATH] [-f [FILTER [FILTER ...]]]
+#                      [-i ITERATIONS] [-p] [-r RESULT_PATH] -j JIT_PATH
+#                      -c CORECLR_RUNTIME_PATH
+#
+# optional arguments:
+#   -h, --help            show this help message and exit
+#   -a {x64,x86}, --arch {x64,x86}
+#                         the target architure
+#   -b {debug,release}, --build {debug,release}
+#                         release or debug build of the CoreCLR tests
+#   -t RUNTEST_PATH, --runtest-path RUNTEST_PATH
+#                         the full path to the CoreCLR\tests directory
+#   -f [FILTER [FILTER ...]], --filter [FILTER [FILTER ...]]
+#                         only run benchmarks whose path contains one of these
+#                         substrings
+#   -i ITERATIONS, --iterations ITERATIONS
+#                         number of runs of each benchmark under each JIT
+#   -p, --precise-gc      run with precise gc (default: conservative gc)
+#   -r RESULT_PATH, --result-path RESULT_PATH
+#                         write the timings as JSON to this file
+#
+# required arguments:
+#   -j JIT_PATH, --jit-path JIT_PATH
+#                         full path to jit .dll
+#   -c CORECLR_RUNTIME_PATH, --coreclr-runtime-path CORECLR_RUNTIME_PATH
+#                         full path to CoreCLR run-time binary directory
+#
+#==========================================================================================
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import time
+import const
+from llilc_runtest import BuiltTestPath, expandPath
+
+# CoreCLR tests report success with this exit code.
+TestPassExitCode = 100
+
+def CollectBenchmarks(root_dir, filters):
+    """ Collect the benchmark executables under root_dir matching any filter."""
+    benchmarks = []
+    for root, dirs, files in os.walk(root_dir):
+        for file in files:
+            if file.endswith('.exe'):
+                path = os.path.join(root, file)
+                relative_path = os.path.relpath(path, root_dir)
+                if not filters or any(f in relative_path for f in filters):
+                    benchmarks.append(relative_path)
+    return sorted(benchmarks)
+
+def JitEnvironment(use_llilc, jit_name, coreclr_runtime_path, benchmark_dir, precise_gc):
+    """ Environment for running a benchmark under LLILC or the default JIT."""
+    env = dict(os.environ)
+    for name in list(env.keys()):
+        if name.upper().startswith('COMPLUS_'):
+            del env[name]
+    if use_llilc:
+        env['COMPlus_AltJit'] = '*'
+        env['COMPlus_AltJitNgen'] = '*'
+        env['COMPlus_AltJitName'] = jit_name
+    if precise_gc:
+        env['COMPlus_InsertStatepoints'] = '1'
+    else:
+        env['COMPlus_GCConservative'] = '1'
+    env['COMPlus_ZapDisable'] = '1'
+    env['CORE_ROOT'] = coreclr_runtime_path
+    env['CORE_LIBRARIES'] = benchmark_dir
+    return env
+
+def RunBenchmark(corerun, benchmark_path, env, iterations):
+    """ Run a benchmark iterations times and return the run times in
+        milliseconds, or None if any run failed.
+    """
+    times = []
+    with open(os.devnull, 'w') as devnull:
+        for i in range(iterations):
+            start = time.time()
+            exit_code = subprocess.call([corerun, benchmark_path], env=env,
+                                        stdout=devnull, stderr=devnull,
+                                        cwd=os.path.dirname(benchmark_path))
+            elapsed = (time.time() - start) * 1000.0
+            if exit_code != TestPassExitCode:
+                return None
+            times.append(elapsed)
+    return times
+
+def Median(values):
+    ordered = sorted(values)
+    mid = len(ordered) // 2
+    if len(ordered) % 2 == 1:
+        return ordered[mid]
+    return (ordered[mid - 1] + ordered[mid]) / 2.0
+
+def FormatTime(times):
+    if times is None:
+        return 'failed'
+    return '{0:.1f}'.format(Median(times))
+
+def main(argv):
+    # define return code const value
+    const.PerfOK = 0
+    const.GeneralError = -1
+    const.UnknownArguments = -2
+    const.InvalidPath = -4
+
+    # Parse the command line
+    parser = argparse.ArgumentParser(description='''Run the CoreCLR code quality
+    benchmarks with LLILC and with the default JIT and report time per run.''')
+    parser.add_argument('-a', '--arch', type=str, choices={'x86', 'x64'},
+                        default='x64', help='the target architure')
+    parser.add_argument('-b', '--build', type=str, choices={'release', 'debug'},
+                        default='release', help='release or debug build of the CoreCLR tests')
+    parser.add_argument('-t', '--runtest-path', type=str,
+                        default=None, help='the full path to the CoreCLR\\tests directory')
+    parser.add_argument('-f', '--filter', type=str, nargs='*', default=[],
+                        help='only run benchmarks whose path contains one of these substrings')
+    parser.add_argument('-i', '--iterations', type=int, default=5,
+                        help='number of runs of each benchmark under each JIT')
+    parser.add_argument('-p', '--precise-gc', help='run with precise gc (default: conservative gc)',
+                        default=False, action="store_true")
+    parser.add_argument('-r', '--result-path', type=str,
+                        help='write the timings as JSON to this file')
+    required = parser.add_argument_group('required arguments')
+    required.add_argument('-j', '--jit-path', required=True,
+                        help='full path to jit .dll')
+    required.add_argument('-c', '--coreclr-runtime-path', required=True,
+                        help='full path to CoreCLR run-time binary directory')
+    args, unknown = parser.parse_known_args(argv)
+
+    if unknown:
+        print('Unknown argument(s): ', ', '.join(unknown))
+        return const.UnknownArguments
+
+    coreclr_runtime_full_path = expandPath(args.coreclr_runtime_path)
+    corerun = os.path.join(coreclr_runtime_full_path, 'CoreRun.exe')
+    if (not os.path.isfile(corerun)):
+        print('Please specify valid --coreclr-runtime-path to CoreCLR run-time binary directory')
+        return const.InvalidPath
+
+    jit_full_path = expandPath(args.jit_path)
+    if (not os.path.isfile(jit_full_path)):
+        print('Please specify valid --jit-path to the jit .dll')
+        return const.InvalidPath
+
+    runtest_dir = args.runtest_path
+    if (runtest_dir is None):
+        runtest_dir = os.getcwd()
+    build_test_path = os.path.join(runtest_dir, BuiltTestPath(str(args.arch), str(args.build)))
+    benchmark_root = os.path.join(build_test_path, 'JIT', 'Performance', 'CodeQuality')
+    if (not os.path.isdir(benchmark_root)):
+        print('Benchmarks not found under ', benchmark_root, '; build the CoreCLR tests first')
+        return const.InvalidPath
+
+    benchmarks = CollectBenchmarks(benchmark_root, args.filter)
+    if not benchmarks:
+        print('No benchmarks match the filter')
+        return const.InvalidPath
+
+    try:
+        # Copy in the jit with a time stamp so concurrent runs don't collide.
+        time_stamp = str(time.time()).split('.')[0]
+        jit_name = 'LLILCJit' + time_stamp + '.dll'
+        time_stamped_jit_path = os.path.join(coreclr_runtime_full_path, jit_name)
+        shutil.copy2(jit_full_path, time_stamped_jit_path)
+    except:
+        e = sys.exc_info()[0]
+        print('Error: Perf failed due to ', e)
+        return const.GeneralError
+
+    results = {}
+    print('{0:<60} {1:>12} {2:>12} {3:>8}'.format('benchmark', 'default ms', 'llilc ms', 'ratio'))
+    try:
+        for benchmark in benchmarks:
+            benchmark_path = os.path.join(benchmark_root, benchmark)
+            benchmark_dir = os.path.dirname(benchmark_path)
+            default_env = JitEnvironment(False, jit_name, coreclr_runtime_full_path,
+                                         benchmark_dir, args.precise_gc)
+            llilc_env = JitEnvironment(True, jit_name, coreclr_runtime_full_path,
+                                       benchmark_dir, args.precise_gc)
+            default_times = RunBenchmark(corerun, benchmark_path, default_env, args.iterations)
+            llilc_times = RunBenchmark(corerun, benchmark_path, llilc_env, args.iterations)
+
+            ratio = None
+            if default_times and llilc_times:
+                ratio = Median(llilc_times) / Median(default_times)
+            results[benchmark] = {'default_ms': default_times, 'llilc_ms': llilc_times,
+                                  'ratio': ratio}
+            print('{0:<60} {1:>12} {2:>12} {3:>8}'.format(
+                  benchmark, FormatTime(default_times), FormatTime(llilc_times),
+                  'n/a' if ratio is None else '{0:.2f}'.format(ratio)))
+    finally:
+        try:
+            os.remove(time_stamped_jit_path)
+        except OSError:
+            pass
+
+    if args.result_path:
+        with open(expandPath(args.result_path), 'w') as result_file:
+            json.dump(results, result_file, indent=2, sort_keys=True)
+
+    return const.PerfOK
+
+if __name__ == '__main__':
+    return_code = main(sys.argv[1:])
+    sys.exit(return_code)
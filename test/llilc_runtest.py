@@ -15,7 +15,7 @@
 # To exclude undesired test cases, please edit exclusion.targets file.
 #
 # usage: llilc_runtest.py [-h] [-a {x64,x86}] [-b {debug,release}] [-p] [-n]
-#                         [-d {summary,verbose}] [-r RESULT_PATH] -j JIT_PATH -c
+#                         [-e] [-m] [-d {summary,verbose}] [-r RESULT_PATH] -j JIT_PATH -c
 #                         CORECLR_RUNTIME_PATH
 # 
 # optional arguments:
@@ -31,6 +31,9 @@
 #   -s,  --insert-statepoints 
 #                         Test with Statepoints inserted, regardless of GC settings.
 #   -e, --eh              enable exception handlers to run (as opposed to failfast)
+#   -m, --metrics         record per-method compile time and native code size
+#                         in the result (implies --dump-level summary if no
+#                         dump level is given)
 #   -r RESULT_PATH, --result-path RESULT_PATH
 #                         the path to runtest result output directory
 # 
@@ -131,6 +134,8 @@ def main(argv):
                          default=False, action="store_true")
     parser.add_argument('-p', '--precise-gc', help='test with precise gc', default=False, action="store_true")
     parser.add_argument('-e', '--eh', help='enable exception handlers to run (as opposed to failfast)', default=False, action="store_true")
+    parser.add_argument('-m', '--metrics', help='record per-method compile time and native code size in the result (implies --dump-level summary if no dump level is given)',
+                        default=False, action="store_true")
     required = parser.add_argument_group('required arguments')
     required.add_argument('-j', '--jit-path', required=True, 
                         help='full path to jit .dll')
@@ -142,6 +147,10 @@ def main(argv):
         print('Unknown argument(s): ', ', '.join(unknown))
         return const.UnknowArguments
 
+    # The metrics are collected from the summary lines of the dump.
+    if args.metrics and args.dump_level is None:
+        args.dump_level = 'summary'
+
     coreclr_runtime_full_path = expandPath(args.coreclr_runtime_path)
     if (not os.path.isdir(coreclr_runtime_full_path)):
         print('Please specify valid --coreclr-runtime-path to CoreCLR run-time binary directory')
@@ -204,6 +213,8 @@ def main(argv):
             test_env.write('chcp 65001\n')
             if args.dump_level is not None:
                 test_env.write('set COMPlus_DumpLLVMIR=' + args.dump_level + '\n')
+                if args.metrics:
+                    test_env.write('set COMPlus_AltJitCodeRangeDump=*\n')
             if args.eh:
                 os.environ["COMPlus_ExecuteHandlers"]="1"
 